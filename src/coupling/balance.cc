@@ -19,6 +19,8 @@
 #include <iostream>
 #include <iomanip>
 #include <unordered_map>
+#include <numeric>
+#include <algorithm>
 
 #include "system/system.hh"
 #include "system/sys_profiler.hh"
@@ -59,6 +61,11 @@ const Record & Balance::get_input_type() {
 		.declare_key("format", Balance::get_format_selection_input_type(), Default("\"txt\""), "Format of output file.")
 		.declare_key("cumulative", Bool(), Default("false"), "Compute cumulative balance over time. "
 				"If true, then balance is calculated at each computational time step, which can slow down the program.")
+		.declare_key("matrix_free", Bool(), Default("false"), "Compute balance directly from local contributions of the equation "
+				"without assembling auxiliary parallel matrices. The values are summed over processes only at the balance output times.")
+		.declare_key("async_output", Bool(), Default("false"), "Sum the balance values over processes by a nonblocking collective operation "
+				"overlapped with the computation of the following time steps. The balance frame is written when the operation is finished, "
+				"at latest at the next balance output time.")
 		.declare_key("file", FileName::output(), Default::read_time("File name generated from the balanced quantity: <quantity_name>_balance.*"), "File name for output of balance.")
 		.close();
 }
@@ -91,6 +98,9 @@ Balance::Balance(const std::string &file_prefix, const Mesh *mesh)
 	      mesh_(mesh),
 	  	  last_time_(),
 	  	  initial_(true),
+	  	  matrix_free_(false),
+	  	  async_output_(false),
+	  	  frame_pending_(false),
 	  	  allocation_done_(false),
           balance_on_(true),
 	  	  output_line_counter_(0),
@@ -105,11 +115,14 @@ Balance::Balance(const std::string &file_prefix, const Mesh *mesh)
 
 Balance::~Balance()
 {
+	// no communication in the destructor, the last frame is finished in output()
+	ASSERT_PERMANENT(! frame_pending_).warning("Reduction of the last balance frame is not finished, the frame is not written.");
 	if (rank_ == 0) {
 		output_.close();
 		if (do_yaml_output_) output_yaml_.close();
 	}
 	if (! allocation_done_) return;
+	if (matrix_free_) return;
 
 	for (unsigned int c=0; c<quantities_.size(); ++c)
 	{
@@ -143,6 +156,8 @@ void Balance::init_from_input(
     balance_output_type_ = tg.equation_fixed_mark_type() | marks.type_balance_output();
 
     cumulative_ = in_rec.val<bool>("cumulative");
+    matrix_free_ = in_rec.val<bool>("matrix_free");
+    async_output_ = in_rec.val<bool>("async_output");
     output_format_ = in_rec.val<OutputFormat>("format");
 
     OutputTimeSet time_set;
@@ -221,9 +236,6 @@ void Balance::lazy_initialize()
         return;
     }
 
-	// Max. number of regions to which a single dof can contribute.
-	// TODO: estimate or compute this number directly (from mesh or dof handler).
-	const int n_bulk_regs_per_dof = min(10, (int)mesh_->region_db().bulk_size());
 	const unsigned int n_quant = quantities_.size();
 	const unsigned int n_bdr_reg = mesh_->region_db().boundary_size();
 	const unsigned int n_blk_reg = mesh_->region_db().bulk_size();
@@ -277,7 +289,70 @@ void Balance::lazy_initialize()
 		increment_fluxes_.resize(n_quant, 0);
 	}
 
+	const unsigned int frame_size = n_quant*(3*n_blk_reg + 2*n_bdr_reg + 2);
+	frame_send_buffer_.resize(frame_size, 0);
+	frame_recv_buffer_.resize(frame_size, 0);
+	frame_increment_fluxes_.resize(n_quant, 0);
+	frame_increment_sources_.resize(n_quant, 0);
+
+	// the equation may destroy its TimeGovernor before a pending balance frame is written
+	time_coef_ = time_->get_coef();
+	time_unit_string_ = time_->get_unit_conversion()->get_unit_string();
+	init_time_ = time_->init_time();
 
+	if (matrix_free_)
+	{
+		local_coefs_.resize(n_quant);
+		for (auto &coefs : local_coefs_)
+		{
+			coefs.mass_vec_.resize(n_blk_reg, 0);
+			coefs.flux_vec_.resize(be_regions_.size(), 0);
+		}
+		be_offset_ = 0;
+	}
+	else
+		allocate_matrices();
+
+    if (rank_ == 0) {
+        // set default value by output_format_
+        std::string default_file_name;
+        switch (output_format_)
+        {
+        case txt:
+            default_file_name = file_prefix_ + "_balance.txt";
+            break;
+        case gnuplot:
+            default_file_name = file_prefix_ + "_balance.dat";
+            break;
+        case legacy:
+            default_file_name = file_prefix_ + "_balance.txt";
+            break;
+        }
+
+        balance_output_file_ = input_record_.val<FilePath>("file", FilePath(default_file_name, FilePath::output_file));
+        try {
+            balance_output_file_.open_stream(output_);
+        } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, input_record_)
+
+
+        // set file name of YAML output
+        if (do_yaml_output_) {
+        	string yaml_file_name = file_prefix_ + "_balance.yaml";
+        	FilePath(yaml_file_name, FilePath::output_file).open_stream(output_yaml_);
+        }
+    }
+
+    allocation_done_ = true;
+}
+
+
+
+void Balance::allocate_matrices()
+{
+	// Max. number of regions to which a single dof can contribute.
+	// TODO: estimate or compute this number directly (from mesh or dof handler).
+	const int n_bulk_regs_per_dof = min(10, (int)mesh_->region_db().bulk_size());
+	const unsigned int n_quant = quantities_.size();
 
 	region_mass_matrix_ = new Mat[n_quant];
 	be_flux_matrix_ = new Mat[n_quant];
@@ -338,37 +413,6 @@ void Balance::lazy_initialize()
 
 	// set be_offset_, used in add_flux_matrix_values()
 	chkerr(VecGetOwnershipRange(be_flux_vec_[0], &be_offset_, NULL));
-    
-    if (rank_ == 0) {
-        // set default value by output_format_
-        std::string default_file_name;
-        switch (output_format_)
-        {
-        case txt:
-            default_file_name = file_prefix_ + "_balance.txt";
-            break;
-        case gnuplot:
-            default_file_name = file_prefix_ + "_balance.dat";
-            break;
-        case legacy:
-            default_file_name = file_prefix_ + "_balance.txt";
-            break;
-        }
-
-        balance_output_file_ = input_record_.val<FilePath>("file", FilePath(default_file_name, FilePath::output_file));
-        try {
-            balance_output_file_.open_stream(output_);
-        } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, input_record_)
-
-
-        // set file name of YAML output
-        if (do_yaml_output_) {
-        	string yaml_file_name = file_prefix_ + "_balance.yaml";
-        	FilePath(yaml_file_name, FilePath::output_file).open_stream(output_yaml_);
-        }
-    }
-
-    allocation_done_ = true;
 }
 
 
@@ -388,6 +432,15 @@ void Balance::start_mass_assembly(unsigned int quantity_idx)
 {
     lazy_initialize();
     if (! balance_on_) return;
+    if (matrix_free_)
+    {
+        LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        coefs.mass_dofs_.clear();
+        coefs.mass_regions_.clear();
+        coefs.mass_vals_.clear();
+        std::fill(coefs.mass_vec_.begin(), coefs.mass_vec_.end(), 0);
+        return;
+    }
 	chkerr(MatZeroEntries(region_mass_matrix_[quantity_idx]));
     chkerr(VecZeroEntries(region_mass_vec_[quantity_idx]));
 }
@@ -397,6 +450,15 @@ void Balance::start_flux_assembly(unsigned int quantity_idx)
 {
     lazy_initialize();
     if (! balance_on_) return;
+    if (matrix_free_)
+    {
+        LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        coefs.flux_edges_.clear();
+        coefs.flux_dofs_.clear();
+        coefs.flux_vals_.clear();
+        std::fill(coefs.flux_vec_.begin(), coefs.flux_vec_.end(), 0);
+        return;
+    }
 	chkerr(MatZeroEntries(be_flux_matrix_[quantity_idx]));
 	chkerr(VecZeroEntries(be_flux_vec_[quantity_idx]));
 }
@@ -406,6 +468,15 @@ void Balance::start_source_assembly(unsigned int quantity_idx)
 {
     lazy_initialize();
     if (! balance_on_) return;
+    if (matrix_free_)
+    {
+        LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        coefs.source_dofs_.clear();
+        coefs.source_regions_.clear();
+        coefs.source_mult_vals_.clear();
+        coefs.source_add_vals_.clear();
+        return;
+    }
 	chkerr(MatZeroEntries(region_source_matrix_[quantity_idx]));
 	chkerr(MatZeroEntries(region_source_rhs_[quantity_idx]));
 }
@@ -415,6 +486,7 @@ void Balance::finish_mass_assembly(unsigned int quantity_idx)
 {
 	ASSERT(allocation_done_);
     if (! balance_on_) return;
+    if (matrix_free_) return;
 
 	chkerr(MatAssemblyBegin(region_mass_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
 	chkerr(MatAssemblyEnd(region_mass_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
@@ -426,6 +498,7 @@ void Balance::finish_flux_assembly(unsigned int quantity_idx)
 {
     ASSERT(allocation_done_);
     if (! balance_on_) return;
+    if (matrix_free_) return;
 
     chkerr(MatAssemblyBegin(be_flux_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
 	chkerr(MatAssemblyEnd(be_flux_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
@@ -437,6 +510,11 @@ void Balance::finish_source_assembly(unsigned int quantity_idx)
 {
     ASSERT(allocation_done_);
     if (! balance_on_) return;
+    if (matrix_free_)
+    {
+        merge_local_sources(quantity_idx);
+        return;
+    }
 
     chkerr(MatAssemblyBegin(region_source_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
 	chkerr(MatAssemblyEnd(region_source_matrix_[quantity_idx], MAT_FINAL_ASSEMBLY));
@@ -454,6 +532,20 @@ void Balance::add_mass_values(unsigned int quantity_idx,
 	ASSERT(allocation_done_);
     if (! balance_on_) return;
 
+    if (matrix_free_)
+    {
+        LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        unsigned int reg_idx = dh_cell.elm().region_idx().bulk_idx();
+        for (uint i=0; i<mat_values.size(); i++)
+        {
+            coefs.mass_dofs_.push_back(loc_dof_indices[i]);
+            coefs.mass_regions_.push_back(reg_idx);
+            coefs.mass_vals_.push_back(mat_values[i]);
+        }
+        coefs.mass_vec_[reg_idx] += vec_value;
+        return;
+    }
+
 	// map local dof indices to global
 	uint m = mat_values.size();
 	int row_dofs[m];
@@ -485,6 +577,20 @@ void Balance::add_flux_values(unsigned int quantity_idx,
 	ASSERT(allocation_done_);
     if (! balance_on_) return;
 
+    if (matrix_free_)
+    {
+        LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        unsigned int be_idx = be_id_map_[get_boundary_edge_uid(SideIter(side.side()))];
+        for (uint i=0; i<mat_values.size(); i++)
+        {
+            coefs.flux_edges_.push_back(be_idx);
+            coefs.flux_dofs_.push_back(loc_dof_indices[i]);
+            coefs.flux_vals_.push_back(mat_values[i]);
+        }
+        coefs.flux_vec_[be_idx] += vec_value;
+        return;
+    }
+
 	// filling row elements corresponding to a boundary edge
 
 	// map local dof indices to global
@@ -519,6 +625,19 @@ void Balance::add_source_values(unsigned int quantity_idx,
     ASSERT(allocation_done_);
     if (! balance_on_) return;
 
+    if (matrix_free_)
+    {
+        LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        for (uint i=0; i<loc_dof_indices.size(); i++)
+        {
+            coefs.source_dofs_.push_back(loc_dof_indices[i]);
+            coefs.source_regions_.push_back(region_idx);
+            coefs.source_mult_vals_.push_back(mult_mat_values[i]);
+            coefs.source_add_vals_.push_back(add_mat_values[i]);
+        }
+        return;
+    }
+
 	PetscInt reg_array[1] = { (int)region_idx };
 
 	chkerr_assert(MatSetValues(region_source_matrix_[quantity_idx],
@@ -539,13 +658,69 @@ void Balance::add_source_values(unsigned int quantity_idx,
 }
 
 
+void Balance::merge_local_sources(unsigned int quantity_idx)
+{
+    LocalCoefficients &coefs = local_coefs_[quantity_idx];
+    const unsigned int n_entries = coefs.source_dofs_.size();
+
+    // Sort entries by (dof, region), which also improves locality of solution access.
+    std::vector<unsigned int> order(n_entries);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&coefs](unsigned int a, unsigned int b) {
+        if (coefs.source_dofs_[a] != coefs.source_dofs_[b]) return coefs.source_dofs_[a] < coefs.source_dofs_[b];
+        return coefs.source_regions_[a] < coefs.source_regions_[b];
+    });
+
+    // Sum up entries of the same (dof, region) pair, as MatSetValues with ADD_VALUES does.
+    // This is necessary for correct splitting of sources to positive and negative part.
+    std::vector<LongIdx> dofs;
+    std::vector<unsigned int> regions;
+    std::vector<double> mult_vals, add_vals;
+    dofs.reserve(n_entries);
+    regions.reserve(n_entries);
+    mult_vals.reserve(n_entries);
+    add_vals.reserve(n_entries);
+    for (unsigned int i : order)
+    {
+        if (!dofs.empty() && dofs.back() == coefs.source_dofs_[i] && regions.back() == coefs.source_regions_[i])
+        {
+            mult_vals.back() += coefs.source_mult_vals_[i];
+            add_vals.back() += coefs.source_add_vals_[i];
+        }
+        else
+        {
+            dofs.push_back(coefs.source_dofs_[i]);
+            regions.push_back(coefs.source_regions_[i]);
+            mult_vals.push_back(coefs.source_mult_vals_[i]);
+            add_vals.push_back(coefs.source_add_vals_[i]);
+        }
+    }
+
+    coefs.source_dofs_.swap(dofs);
+    coefs.source_regions_.swap(regions);
+    coefs.source_mult_vals_.swap(mult_vals);
+    coefs.source_add_vals_.swap(add_vals);
+}
+
+
+void Balance::calculate_local_edge_fluxes(unsigned int quantity_idx,
+        const double *sol_array,
+        std::vector<double> &edge_fluxes)
+{
+    const LocalCoefficients &coefs = local_coefs_[quantity_idx];
+    edge_fluxes = coefs.flux_vec_;
+    for (unsigned int i=0; i<coefs.flux_dofs_.size(); ++i)
+        edge_fluxes[ coefs.flux_edges_[i] ] += coefs.flux_vals_[i] * sol_array[ coefs.flux_dofs_[i] ];
+}
+
+
 void Balance::add_cumulative_source(unsigned int quantity_idx, double source)
 {
     ASSERT(allocation_done_);
     if (!cumulative_) return;
 
-    if (rank_ == 0)
-        increment_sources_[quantity_idx] += source;
+    // local part of the source, the sum over processes is done in output()
+    increment_sources_[quantity_idx] += source;
 }
 
 
@@ -556,6 +731,29 @@ void Balance::calculate_cumulative(unsigned int quantity_idx,
 	if (!cumulative_) return;
     if (time_->tlevel() <= 0) return;
 
+    if (matrix_free_)
+    {
+        // Only local contributions are summed, the sum over processes is done in output().
+        const LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        const double *sol_array;
+        chkerr(VecGetArrayRead(solution, &sol_array));
+
+        double temp_source = 0;
+        for (unsigned int i=0; i<coefs.source_dofs_.size(); ++i)
+            temp_source += coefs.source_mult_vals_[i]*sol_array[coefs.source_dofs_[i]] + coefs.source_add_vals_[i];
+
+        std::vector<double> edge_fluxes;
+        calculate_local_edge_fluxes(quantity_idx, sol_array, edge_fluxes);
+        chkerr(VecRestoreArrayRead(solution, &sol_array));
+
+        double sum_fluxes = std::accumulate(edge_fluxes.begin(), edge_fluxes.end(), 0.0);
+        increment_sources_[quantity_idx] += temp_source*time_->dt();
+        // Since internally we keep outgoing fluxes, we change sign
+        // to write to output _incoming_ fluxes.
+        increment_fluxes_[quantity_idx] += -1.0 * sum_fluxes*time_->dt();
+        return;
+    }
+
     // sources
     double temp_source = 0;
     int lsize, n_cols_mat, n_cols_rhs;
@@ -595,16 +793,20 @@ void Balance::calculate_cumulative(unsigned int quantity_idx,
 			&temp));
     
 	chkerr(MatMultAdd(be_flux_matrix_[quantity_idx], solution, be_flux_vec_[quantity_idx], temp));
-	
-    double sum_fluxes;
-	chkerr(VecSum(temp, &sum_fluxes));
+
+	// sum of local fluxes, the sum over processes is done in output()
+	double sum_fluxes = 0;
+	const double *flux_array;
+	chkerr(VecGetArrayRead(temp, &flux_array));
+	for (unsigned int e=0; e<be_regions_.size(); ++e)
+		sum_fluxes += flux_array[e];
+	chkerr(VecRestoreArrayRead(temp, &flux_array));
 	chkerr(VecDestroy(&temp));
 
-	if (rank_ == 0)
-		// sum fluxes in one step
-        // Since internally we keep outgoing fluxes, we change sign
-        // to write to output _incoming_ fluxes.
-		increment_fluxes_[quantity_idx] += -1.0 * sum_fluxes*time_->dt();
+	// sum fluxes in one step
+	// Since internally we keep outgoing fluxes, we change sign
+	// to write to output _incoming_ fluxes.
+	increment_fluxes_[quantity_idx] += -1.0 * sum_fluxes*time_->dt();
 }
 
 
@@ -615,27 +817,84 @@ void Balance::calculate_mass(unsigned int quantity_idx,
     ASSERT(allocation_done_);
     if (! balance_on_) return;
 
-    Vec bulk_vec;
+    if (matrix_free_)
+    {
+        // Local part of mass, the sum over processes is done in output().
+        const LocalCoefficients &coefs = local_coefs_[quantity_idx];
+        const double *sol_array;
+        chkerr(VecGetArrayRead(solution, &sol_array));
+        output_array = coefs.mass_vec_;
+        for (unsigned int i=0; i<coefs.mass_dofs_.size(); ++i)
+            output_array[ coefs.mass_regions_[i] ] += coefs.mass_vals_[i] * sol_array[ coefs.mass_dofs_[i] ];
+        chkerr(VecRestoreArrayRead(solution, &sol_array));
+        return;
+    }
 
-	chkerr(VecCreateMPIWithArray(PETSC_COMM_WORLD,
-			1,
-			(rank_==0)?mesh_->region_db().bulk_size():0,
-			PETSC_DECIDE,
-			&(output_array[0]),
-			&bulk_vec));
-
-	// compute mass on regions: M'.u
-	chkerr(VecZeroEntries(bulk_vec));
-	chkerr(MatMultTransposeAdd(region_mass_matrix_[quantity_idx], 
-                               solution, 
-                               region_mass_vec_[quantity_idx], 
-                               bulk_vec));
-	chkerr(VecDestroy(&bulk_vec));
+    // compute local part of mass on regions: M'.u + mv
+    // Rows of M are distributed as the solution, so no communication is necessary,
+    // the sum over processes is done in output().
+    PetscInt row_begin, row_end, n_cols, mv_lsize;
+    const PetscInt *cols;
+    const double *vals, *sol_array, *mv_array;
+    output_array.assign(mesh_->region_db().bulk_size(), 0);
+
+    chkerr(MatGetOwnershipRange(region_mass_matrix_[quantity_idx], &row_begin, &row_end));
+    chkerr(VecGetArrayRead(solution, &sol_array));
+    for (PetscInt row=row_begin; row<row_end; ++row)
+    {
+        chkerr(MatGetRow(region_mass_matrix_[quantity_idx], row, &n_cols, &cols, &vals));
+        for (PetscInt j=0; j<n_cols; ++j)
+            output_array[cols[j]] += vals[j]*sol_array[row-row_begin];
+        chkerr(MatRestoreRow(region_mass_matrix_[quantity_idx], row, &n_cols, &cols, &vals));
+    }
+    chkerr(VecRestoreArrayRead(solution, &sol_array));
+
+    // mv is owned by process #0
+    chkerr(VecGetLocalSize(region_mass_vec_[quantity_idx], &mv_lsize));
+    chkerr(VecGetArrayRead(region_mass_vec_[quantity_idx], &mv_array));
+    for (PetscInt r=0; r<mv_lsize; ++r)
+        output_array[r] += mv_array[r];
+    chkerr(VecRestoreArrayRead(region_mass_vec_[quantity_idx], &mv_array));
 }
 
+void Balance::calculate_local_instant(unsigned int quantity_idx, const Vec& solution)
+{
+    const LocalCoefficients &coefs = local_coefs_[quantity_idx];
+    const double *sol_array;
+    chkerr(VecGetArrayRead(solution, &sol_array));
+
+    // positive/negative sources
+    for (unsigned int i=0; i<coefs.source_dofs_.size(); ++i)
+    {
+        double f = coefs.source_mult_vals_[i]*sol_array[coefs.source_dofs_[i]] + coefs.source_add_vals_[i];
+        if (f > 0) sources_in_[quantity_idx][coefs.source_regions_[i]] += f;
+        else sources_out_[quantity_idx][coefs.source_regions_[i]] += f;
+    }
+
+    // positive/negative fluxes, sign is switched to get _incoming_ fluxes
+    std::vector<double> edge_fluxes;
+    calculate_local_edge_fluxes(quantity_idx, sol_array, edge_fluxes);
+    chkerr(VecRestoreArrayRead(solution, &sol_array));
+
+    fluxes_in_[quantity_idx].assign(mesh_->region_db().boundary_size(), 0);
+    fluxes_out_[quantity_idx].assign(mesh_->region_db().boundary_size(), 0);
+    for (unsigned int e=0; e<edge_fluxes.size(); ++e)
+    {
+        double flux = -edge_fluxes[e];
+        if (flux < 0)
+            fluxes_out_[quantity_idx][be_regions_[e]] += flux;
+        else
+            fluxes_in_[quantity_idx][be_regions_[e]] += flux;
+    }
+}
+
+
 void Balance::calculate_instant(unsigned int quantity_idx, const Vec& solution)
 {
     if ( !is_current() ) return;
+
+    // values of the previous frame must be written before they are overwritten
+    finish_frame_reduction();
     
     calculate_mass(quantity_idx, solution, masses_[quantity_idx]);
     
@@ -645,6 +904,12 @@ void Balance::calculate_instant(unsigned int quantity_idx, const Vec& solution)
         sources_in_[quantity_idx][r] = 0;
 		sources_out_[quantity_idx][r] = 0;
     }
+
+    if (matrix_free_)
+    {
+        calculate_local_instant(quantity_idx, solution);
+        return;
+    }
     
     int lsize, n_cols_mat, n_cols_rhs;
     const int *cols;    // the columns must be same - matrices created and filled in the same way
@@ -715,54 +980,96 @@ void Balance::output()
     ASSERT(allocation_done_);
     if (! balance_on_) return;
     if (! is_current() ) return;
-    
+
+    finish_frame_reduction();
+
 	// gather results from processes and sum them up
+	pack_frame_buffer();
+	frame_time_ = time_->t();
+
+	// increments of the frame are packed, start accumulation of the next ones
+	increment_fluxes_.assign(quantities_.size(), 0);
+	increment_sources_.assign(quantities_.size(), 0);
+
+	if (async_output_)
+	{
+		MPI_Ireduce(&(frame_send_buffer_[0]), &(frame_recv_buffer_[0]), frame_send_buffer_.size(),
+				MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD, &frame_request_);
+		frame_pending_ = true;
+
+		// the last frame of the equation is finished immediately
+		auto &marks = TimeGovernor::marks();
+		if ( time_->is_end() || time_->step().ge( marks.last(balance_output_type_)->time() ) )
+			finish_frame_reduction();
+	}
+	else
+	{
+		MPI_Reduce(&(frame_send_buffer_[0]), &(frame_recv_buffer_[0]), frame_send_buffer_.size(),
+				MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD);
+		output_frame();
+	}
+}
+
+
+void Balance::finish_frame_reduction()
+{
+	if (! frame_pending_) return;
+
+	MPI_Wait(&frame_request_, MPI_STATUS_IGNORE);
+	frame_pending_ = false;
+	output_frame();
+}
+
+
+void Balance::pack_frame_buffer()
+{
     const unsigned int n_quant = quantities_.size();
 	const unsigned int n_blk_reg = mesh_->region_db().bulk_size();
 	const unsigned int n_bdr_reg = mesh_->region_db().boundary_size();
-	const int buf_size = n_quant*2*n_blk_reg + n_quant*2*n_bdr_reg + n_quant;
-	double sendbuffer[buf_size], recvbuffer[buf_size];
+
+	// Layout of the buffer: blocks of all quantities, each block contains
+	// [sources_in, sources_out, masses] per bulk region, [fluxes_in, fluxes_out] per boundary region
+	// and increments of flux and source.
+	// Masses and increments are local partial sums of processes.
+	const unsigned int q_size = 3*n_blk_reg + 2*n_bdr_reg + 2;
 	for (unsigned int qi=0; qi<n_quant; qi++)
 	{
-		for (unsigned int ri=0; ri<n_blk_reg; ri++)
-		{
-			sendbuffer[qi*2*n_blk_reg +           + ri] = sources_in_[qi][ri];
-			sendbuffer[qi*2*n_blk_reg + n_blk_reg + ri] = sources_out_[qi][ri];
-		}
-		for (unsigned int ri=0; ri<n_bdr_reg; ri++)
-		{
-			sendbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg +           + ri] = fluxes_in_[qi][ri];
-			sendbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg + n_bdr_reg + ri] = fluxes_out_[qi][ri];
-		}
-		if (cumulative_)
-        {
-            sendbuffer[n_quant*2*n_blk_reg + n_quant*2*n_bdr_reg + qi] = increment_sources_[qi];
-        }
+		double *buf = &(frame_send_buffer_[qi*q_size]);
+		std::copy(sources_in_[qi].begin(),  sources_in_[qi].end(),  buf);
+		std::copy(sources_out_[qi].begin(), sources_out_[qi].end(), buf + n_blk_reg);
+		std::copy(masses_[qi].begin(),      masses_[qi].end(),      buf + 2*n_blk_reg);
+		std::copy(fluxes_in_[qi].begin(),   fluxes_in_[qi].end(),   buf + 3*n_blk_reg);
+		std::copy(fluxes_out_[qi].begin(),  fluxes_out_[qi].end(),  buf + 3*n_blk_reg + n_bdr_reg);
+		buf[q_size-2] = (cumulative_) ? increment_fluxes_[qi] : 0;
+		buf[q_size-1] = (cumulative_) ? increment_sources_[qi] : 0;
 	}
-    
-	MPI_Reduce(&sendbuffer,recvbuffer,buf_size,MPI_DOUBLE,MPI_SUM,0,PETSC_COMM_WORLD);
+}
+
+
+void Balance::output_frame()
+{
+    const unsigned int n_quant = quantities_.size();
+
 	// for other than 0th process update last_time and finish,
 	// on process #0 sum balances over all regions and calculate
 	// cumulative balance over time.
 	if (rank_ == 0)
 	{
+		const unsigned int n_blk_reg = mesh_->region_db().bulk_size();
+		const unsigned int n_bdr_reg = mesh_->region_db().boundary_size();
+		const unsigned int q_size = 3*n_blk_reg + 2*n_bdr_reg + 2;
+
 		// update balance vectors
 		for (unsigned int qi=0; qi<n_quant; qi++)
 		{
-			for (unsigned int ri=0; ri<n_blk_reg; ri++)
-			{
-				sources_in_[qi][ri]  = recvbuffer[qi*2*n_blk_reg +           + ri];
-				sources_out_[qi][ri] = recvbuffer[qi*2*n_blk_reg + n_blk_reg + ri];
-			}
-			for (unsigned int ri=0; ri<n_bdr_reg; ri++)
-			{
-				fluxes_in_[qi][ri]  = recvbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg +           + ri];
-				fluxes_out_[qi][ri] = recvbuffer[n_quant*2*n_blk_reg + qi*2*n_bdr_reg + n_bdr_reg + ri];
-			}
-			if (cumulative_)
-            {
-                increment_sources_[qi] = recvbuffer[n_quant*2*n_blk_reg + n_quant*2*n_bdr_reg + qi];
-            }
+			const double *buf = &(frame_recv_buffer_[qi*q_size]);
+			sources_in_[qi] .assign(buf,                           buf + n_blk_reg);
+			sources_out_[qi].assign(buf + n_blk_reg,               buf + 2*n_blk_reg);
+			masses_[qi]     .assign(buf + 2*n_blk_reg,             buf + 3*n_blk_reg);
+			fluxes_in_[qi]  .assign(buf + 3*n_blk_reg,             buf + 3*n_blk_reg + n_bdr_reg);
+			fluxes_out_[qi] .assign(buf + 3*n_blk_reg + n_bdr_reg, buf + 3*n_blk_reg + 2*n_bdr_reg);
+			frame_increment_fluxes_[qi]  = buf[q_size-2];
+			frame_increment_sources_[qi] = buf[q_size-1];
 		}
 	}
 
@@ -810,7 +1117,7 @@ void Balance::output()
 			// save initial time and mass
 			if (initial_)
 			{
-				last_time_ = time_->init_time();
+				last_time_ = init_time_;
 				for (unsigned int qi=0; qi<n_quant; qi++)
 					initial_mass_[qi] = sum_masses_[qi];
 				initial_ = false;
@@ -818,38 +1125,36 @@ void Balance::output()
 
 			for (unsigned int qi=0; qi<n_quant; qi++)
 			{
-				integrated_fluxes_[qi] += increment_fluxes_[qi];
-				integrated_sources_[qi] += increment_sources_[qi];
+				integrated_fluxes_[qi] += frame_increment_fluxes_[qi];
+				integrated_sources_[qi] += frame_increment_sources_[qi];
 			}
 		}
 	}
 
-	last_time_ = time_->t();
+	last_time_ = frame_time_;
 
 
 	// perform actual output
 	switch (output_format_)
 	{
 	case txt:
-		output_csv(time_->t(), '\t', "");
+		output_csv(frame_time_, '\t', "");
 		break;
 	case gnuplot:
-		output_csv(time_->t(), ' ', "#", 30);
+		output_csv(frame_time_, ' ', "#", 30);
 		break;
 	case legacy:
-		output_legacy(time_->t());
+		output_legacy(frame_time_);
 		break;
 	}
 	// output in YAML format
-	output_yaml(time_->t());
+	output_yaml(frame_time_);
 
 	if (rank_ == 0)
 	{
 		sum_fluxes_.assign(n_quant, 0);
 		sum_sources_.assign(n_quant, 0);
-		increment_fluxes_.assign(n_quant, 0);
 	}
-	increment_sources_.assign(n_quant, 0);
 }
 
 
@@ -871,8 +1176,8 @@ void Balance::output_legacy(double time)
 	output_ << "# " << setw((w*c+wl-14)/2) << setfill('-') << "--"
 			<< " MASS BALANCE "
 	     	<< setw((w*c+wl-14)/2) << setfill('-') << "" << endl
-			<< "# Time: " << (time / time_->get_coef())
-			<< "[" << time_->get_unit_conversion()->get_unit_string() << "]\n\n\n";
+			<< "# Time: " << (time / time_coef_)
+			<< "[" << time_unit_string_ << "]\n\n\n";
 
 	// header for table of boundary fluxes
 	output_ << "# Mass flux through boundary [M/T]:\n# "
@@ -965,7 +1270,7 @@ void Balance::output_legacy(double time)
 	{
 		// Print cumulative sources
 		output_ << "\n\n# Cumulative mass balance on time interval ["
-				<< setiosflags(ios::left) << time_->init_time() << ","
+				<< setiosflags(ios::left) << init_time_ << ","
 				<< setiosflags(ios::left) << time << "]\n"
 				<< "# Initial mass [M] + sources integrated over time [M] - flux integrated over time [M] = current mass [M]\n"
 				<< "# " << setiosflags(ios::left)
@@ -1026,7 +1331,7 @@ void Balance::output_csv(double time, char delimiter, const std::string& comment
 			// print data header (repeat header after every "repeat" lines)
 			if (repeat && (output_line_counter_%repeat == 0)) format_csv_output_header(delimiter, comment_string);
 
-			output_ << format_csv_val(time / time_->get_coef(), delimiter, true)
+			output_ << format_csv_val(time / time_coef_, delimiter, true)
 					<< format_csv_val(reg->label(), delimiter)
 					<< format_csv_val(quantities_[qi].name_, delimiter)
 					<< csv_zero_vals(3, delimiter)
@@ -1047,7 +1352,7 @@ void Balance::output_csv(double time, char delimiter, const std::string& comment
 			// print data header (repeat header after every "repeat" lines)
 			if (repeat && (output_line_counter_%repeat == 0)) format_csv_output_header(delimiter, comment_string);
 
-			output_ << format_csv_val(time / time_->get_coef(), delimiter, true)
+			output_ << format_csv_val(time / time_coef_, delimiter, true)
 					<< format_csv_val(reg->label(), delimiter)
 					<< format_csv_val(quantities_[qi].name_, delimiter)
 					<< format_csv_val(fluxes_in_[qi][reg->boundary_idx()] + fluxes_out_[qi][reg->boundary_idx()], delimiter)
@@ -1071,7 +1376,7 @@ void Balance::output_csv(double time, char delimiter, const std::string& comment
             // DebugOut().fmt("error_[qi]={:.15e} sum_masses_[qi]={:.15e}, initial_mass_[qi]={:.15e}, integrated_sources_[qi]={:.15e}, integrated_fluxes_[qi]={:.15e}",
                 // error, sum_masses_[qi], initial_mass_[qi], integrated_sources_[qi], integrated_fluxes_[qi]);
 
-			output_ << format_csv_val(time / time_->get_coef(), delimiter, true)
+			output_ << format_csv_val(time / time_coef_, delimiter, true)
 					<< format_csv_val("ALL", delimiter)
 					<< format_csv_val(quantities_[qi].name_, delimiter)
 					<< format_csv_val(sum_fluxes_[qi], delimiter)
@@ -1081,8 +1386,8 @@ void Balance::output_csv(double time, char delimiter, const std::string& comment
 					<< format_csv_val(sum_sources_[qi], delimiter)
 					<< format_csv_val(sum_sources_in_[qi], delimiter)
 					<< format_csv_val(sum_sources_out_[qi], delimiter)
-					<< format_csv_val(increment_fluxes_[qi], delimiter)
-					<< format_csv_val(increment_sources_[qi], delimiter)
+					<< format_csv_val(frame_increment_fluxes_[qi], delimiter)
+					<< format_csv_val(frame_increment_sources_[qi], delimiter)
 					<< format_csv_val(integrated_fluxes_[qi], delimiter)
 					<< format_csv_val(integrated_sources_[qi], delimiter)
 					<< format_csv_val(error, delimiter) << endl;
@@ -1098,9 +1403,9 @@ void Balance::format_csv_output_header(char delimiter, const std::string& commen
 	std::stringstream ss;
 	if (delimiter == ' ') {
 		ss << setw(output_column_width-comment_string.size())
-		   << "\"time [" << time_->get_unit_conversion()->get_unit_string() << "]\"";
+		   << "\"time [" << time_unit_string_ << "]\"";
 	} else {
-		ss << "\"time [" << time_->get_unit_conversion()->get_unit_string() << "]\"";
+		ss << "\"time [" << time_unit_string_ << "]\"";
 	}
 
 	output_ << comment_string << ss.str()
@@ -1175,7 +1480,7 @@ void Balance::output_yaml(double time)
 	{
 		for (unsigned int qi=0; qi<n_quant; qi++)
 		{
-			output_yaml_ << "  - time: " << (time / time_->get_coef()) << endl;
+			output_yaml_ << "  - time: " << (time / time_coef_) << endl;
 			output_yaml_ << setw(4) << "" << "region: " << reg->label() << endl;
 			output_yaml_ << setw(4) << "" << "quantity: " << quantities_[qi].name_ << endl;
 			output_yaml_ << setw(4) << "" << "data: " << "[ 0, 0, 0, " << masses_[qi][reg->bulk_idx()] << ", "
@@ -1190,7 +1495,7 @@ void Balance::output_yaml(double time)
 	for( RegionSet::const_iterator reg = b_set.begin(); reg != b_set.end(); ++reg)
 	{
 		for (unsigned int qi=0; qi<n_quant; qi++) {
-			output_yaml_ << "  - time: " << (time / time_->get_coef()) << endl;
+			output_yaml_ << "  - time: " << (time / time_coef_) << endl;
 			output_yaml_ << setw(4) << "" << "region: " << reg->label() << endl;
 			output_yaml_ << setw(4) << "" << "quantity: " << quantities_[qi].name_ << endl;
 			output_yaml_ << setw(4) << "" << "data: " << "[ "
@@ -1205,14 +1510,14 @@ void Balance::output_yaml(double time)
 		for (unsigned int qi=0; qi<n_quant; qi++)
 		{
 			double error = sum_masses_[qi] - (initial_mass_[qi] + integrated_sources_[qi] + integrated_fluxes_[qi]);
-			output_yaml_ << "  - time: " << (time / time_->get_coef()) << endl;
+			output_yaml_ << "  - time: " << (time / time_coef_) << endl;
 			output_yaml_ << setw(4) << "" << "region: ALL" << endl;
 			output_yaml_ << setw(4) << "" << "quantity: " << quantities_[qi].name_ << endl;
 			output_yaml_ << setw(4) << "" << "data: " << "[ " << sum_fluxes_[qi] << ", "
 					     << sum_fluxes_in_[qi] << ", " << sum_fluxes_out_[qi] << ", "
 						 << sum_masses_[qi] << ", " << sum_sources_[qi] << ", "
 						 << sum_sources_in_[qi] << ", " << sum_sources_out_[qi] << ", "
-						 << increment_fluxes_[qi] << ", " << increment_sources_[qi] << ", "
+						 << frame_increment_fluxes_[qi] << ", " << frame_increment_sources_[qi] << ", "
 						 << integrated_fluxes_[qi] << ", " << integrated_sources_[qi] << ", "
 						 << error << " ]" << endl;
 		}
@@ -115,6 +115,14 @@ namespace Input {
  *
  * error = current_mass - (initial_mass + integrated_source - integrated_flux)
  *
+ *
+ * Matrix-free mode (input key 'matrix_free'):
+ *
+ * The PETSc matrices M, F, S, SV and vectors mv, fv are not created. Coefficients added by the equations
+ * are kept in flat local arrays (see @p LocalCoefficients) addressed by local dof indices, and the region values
+ * are accumulated directly from the local part of the solution (including ghost values). The partial sums of
+ * particular processes are reduced only once per balance output in output().
+ *
  */
 class Balance {
 public:
@@ -140,6 +148,36 @@ public:
 
 	};
 
+	/**
+	 * Balance coefficients of a single quantity stored on the local process in the matrix-free mode.
+	 *
+	 * Every matrix entry is stored as a triplet of the local dof index (to the solution vector),
+	 * the bulk region or local boundary edge and the coefficient.
+	 */
+	struct LocalCoefficients {
+		/// Entries of the mass matrix M.
+		std::vector<LongIdx> mass_dofs_;
+		std::vector<unsigned int> mass_regions_;
+		std::vector<double> mass_vals_;
+
+		/// Local part of the mass vector mv (n_bulk_regions).
+		std::vector<double> mass_vec_;
+
+		/// Entries of the source matrices S and SV, merged per (dof, region) pair in finish_source_assembly().
+		std::vector<LongIdx> source_dofs_;
+		std::vector<unsigned int> source_regions_;
+		std::vector<double> source_mult_vals_;
+		std::vector<double> source_add_vals_;
+
+		/// Entries of the flux matrix F.
+		std::vector<unsigned int> flux_edges_;
+		std::vector<LongIdx> flux_dofs_;
+		std::vector<double> flux_vals_;
+
+		/// Flux vector fv (n_local_boundary_edges).
+		std::vector<double> flux_vec_;
+	};
+
 	/**
 	 * Possible formats of output file.
 	 */
@@ -189,6 +227,9 @@ public:
 	/// Getter for cumulative_.
 	inline bool cumulative() const { return cumulative_; }
 
+	/// Getter for matrix_free_.
+	inline bool matrix_free() const { return matrix_free_; }
+
 
 	/**
 	 * Define a single conservative quantity.
@@ -359,9 +400,11 @@ public:
 
 	/**
 	 * Calculates actual mass and save it to given vector.
+	 * The masses are partial sums over the elements of the local process,
+	 * the total mass is the sum over all processes (done in output()).
 	 * @param quantity_idx  Index of quantity.
 	 * @param solution      Solution vector.
-	 * @param output_array	Vector of output masses per region.
+	 * @param output_array	Vector of local parts of masses per region (output).
 	 */
 	void calculate_mass(unsigned int quantity_idx,
 			const Vec &solution,
@@ -377,15 +420,25 @@ public:
 
     /**
 	* Adds provided values to the cumulative sources.
+	* Every process adds its local part of the source, the sum over processes is done in output().
 	* @param quantity_idx Index of quantity.
 	* @param sources Sources per region.
 	* @param dt Actual time step.
 	*/
 	void add_cumulative_source(unsigned int quantity_idx, double source);
 
-	/// Perform output to file for given time instant.
+	/**
+	 * Perform output to file for given time instant.
+	 * All values of the balance frame are summed over processes by a single reduction.
+	 * If 'async_output' is set, the reduction is nonblocking and the frame is written
+	 * in finish_frame_reduction(). The frame of the last balance time is always finished
+	 * here, so that no communication is left for the destructor.
+	 */
 	void output();
 
+	/// Wait for the pending reduction of a balance frame (if any) and write the frame.
+	void finish_frame_reduction();
+
 private:
 	/// Size of column in output (used if delimiter is space)
 	static const unsigned int output_column_width = 20;
@@ -398,6 +451,18 @@ private:
 	 */
 	void lazy_initialize();
 
+	/// Create PETSc matrices and vectors of balance, not used in the matrix-free mode.
+	void allocate_matrices();
+
+	/// Implementation of calculate_instant() (except of mass) in the matrix-free mode.
+	void calculate_local_instant(unsigned int quantity_idx, const Vec &solution);
+
+	/// Copy local values of all quantities and regions to the contiguous buffer frame_send_buffer_.
+	void pack_frame_buffer();
+
+	/// Unpack the reduced values from frame_recv_buffer_, compute sums over regions and write the frame.
+	void output_frame();
+
 	/// Perform output in old format (for compatibility)
 	void output_legacy(double time);
 
@@ -426,6 +491,19 @@ private:
     inline LongIdx get_boundary_edge_uid(SideIter side)
     { return 4*side->elem_idx() + side->side_idx();}    // 4 is maximum of sides per element
 
+    /// Merge source entries with the same (dof, region) pair in the matrix-free mode.
+    void merge_local_sources(unsigned int quantity_idx);
+
+    /**
+     * Computes outgoing fluxes F*solution+fv on local boundary edges in the matrix-free mode.
+     * @param quantity_idx  Index of quantity.
+     * @param sol_array     Local part of the solution vector (including ghost values).
+     * @param edge_fluxes   Output vector of fluxes per local boundary edge.
+     */
+    void calculate_local_edge_fluxes(unsigned int quantity_idx,
+            const double *sol_array,
+            std::vector<double> &edge_fluxes);
+
 	//**********************************************
 
 	static bool do_yaml_output_;
@@ -478,6 +556,9 @@ private:
     /// Vectors for calculation of mass (n_bulk_regions).
     Vec *region_mass_vec_;
 
+    /// Local balance coefficients of quantities, used instead of the above matrices in the matrix-free mode.
+    std::vector<LocalCoefficients> local_coefs_;
+
     /** Maps unique identifier of (local bulk element idx, side idx) returned by @p get_boundary_edge_uid(side)
      * to local boundary edge.
      * Example usage:
@@ -532,6 +613,34 @@ private:
 	/// if true then cumulative balance is computed
 	bool cumulative_;
 
+	/// if true then balance is computed from local coefficients without PETSc matrices
+	bool matrix_free_;
+
+	/// if true then the reduction of balance frame is overlapped with following computation
+	bool async_output_;
+
+	/// Send and receive buffer of the reduction of all balance values of a single output frame.
+	std::vector<double> frame_send_buffer_;
+	std::vector<double> frame_recv_buffer_;
+
+	/// Request of nonblocking reduction of the frame buffer.
+	MPI_Request frame_request_;
+
+	/// true if the reduction of the frame buffer is in progress
+	bool frame_pending_;
+
+	/// Time of the last (possibly pending) balance frame.
+	double frame_time_;
+
+	/// Increments of cumulative flux and source of the last frame summed over processes.
+	std::vector<double> frame_increment_fluxes_;
+	std::vector<double> frame_increment_sources_;
+
+	/// Time unit data copied from time_, since the frame can be written after the TimeGovernor is destroyed.
+	double time_coef_;
+	std::string time_unit_string_;
+	double init_time_;
+
 	/// true before allocating necessary internal structures (Petsc matrices etc.)
 	bool allocation_done_;
 
@@ -24,6 +24,10 @@
 #include "fields/field_value_cache.hh"
 #include "tools/revertable_list.hh"
 #include "system/sys_profiler.hh"
+#include "system/index_types.hh"
+
+#include <functional>
+#include <vector>
 
 
 
@@ -253,6 +257,47 @@ public:
         END_TIMER( DimAssembly<1>::name() );
     }
 
+    /**
+     * @brief Symbolic assembly of the matrix pattern.
+     *
+     * Traverses the same cells, edges and neighbours as @p assemble and passes global DOF indices
+     * of the cells coupled by each active integral to @p add_block (all DOFs are coupled with each other).
+     * Fields and local matrices are not evaluated.
+     */
+    void assemble_pattern(std::shared_ptr<DOFHandlerMultiDim> dh,
+            std::function<void(const std::vector<LongIdx> &)> add_block) const {
+        START_TIMER("assemble_pattern");
+        std::vector<LongIdx> dofs, cell_dofs;
+        for (auto cell : dh->local_range()) {
+            if ( (active_integrals_ & (ActiveIntegrals::bulk | ActiveIntegrals::boundary)) && cell.is_own() ) {
+                cell.get_dof_indices(dofs);
+                add_block(dofs);
+            }
+
+            if (active_integrals_ & ActiveIntegrals::edge)
+                for( DHCellSide cell_side : cell.side_range() ) {
+                    if ( (cell_side.n_edge_sides() < min_edge_sides_) || (cell_side.edge_sides().begin()->element().idx() != cell.elm_idx()) )
+                        continue;
+                    dofs.clear();
+                    for( DHCellSide edge_side : cell_side.edge_sides() ) {
+                        edge_side.cell().get_dof_indices(cell_dofs);
+                        dofs.insert(dofs.end(), cell_dofs.begin(), cell_dofs.end());
+                    }
+                    add_block(dofs);
+                }
+
+            if (active_integrals_ & ActiveIntegrals::coupling)
+                for( DHCellSide neighb_side : cell.neighb_sides() ) {
+                    if (cell.dim() != neighb_side.dim()-1) continue;
+                    cell.get_dof_indices(dofs);
+                    neighb_side.cell().get_dof_indices(cell_dofs);
+                    dofs.insert(dofs.end(), cell_dofs.begin(), cell_dofs.end());
+                    add_block(dofs);
+                }
+        }
+        END_TIMER("assemble_pattern");
+    }
+
     /// Return ElementCacheMap
     inline const ElementCacheMap &cache_map() const {
         return element_cache_map_;
@@ -220,7 +220,9 @@ HM_Iterative::HM_Iterative(Mesh &mesh, Input::Record in_record)
 : DarcyFlowInterface(mesh, in_record),
   IterativeCoupling(in_record),
   flow_potential_assembly_(nullptr),
-  residual_assembly_(nullptr)
+  residual_assembly_(nullptr),
+  flow_r_tol_(0.0),
+  mechanics_r_tol_(0.0)
 {
 	START_TIMER("HM constructor");
     using namespace Input;
@@ -271,6 +273,9 @@ void HM_Iterative::initialize()
     flow_potential_assembly_ = new GenericAssembly<FlowPotentialAssemblyHM>(eq_fields_.get(), eq_data_.get());
     residual_assembly_ = new GenericAssembly<ResidualAssemblyHM>(eq_fields_.get(), eq_data_.get());
 
+    flow_r_tol_ = eq_data_->flow_->eq_data().lin_sys_schur->get_relative_accuracy();
+    mechanics_r_tol_ = eq_data_->mechanics_->eq_data().ls->get_relative_accuracy();
+
     Input::Array user_fields_arr;
     if (input_record_.opt_val("user_fields", user_fields_arr)) {
         FieldSet sham_eq_output; // only for correct call of init_user_fields method
@@ -312,15 +317,22 @@ void HM_Iterative::update_solution()
     time_->view("HM");
     eq_fields_->set_time(time_->step(), LimitSide::right);
 
+    acceleration_.start(accelerated_vectors());
     solve_step();
 }
 
 void HM_Iterative::solve_iteration()
 {
+    if (adaptive_inner_tolerance_) set_inner_tolerances(false);
+
     // pass displacement (divergence) to flow
     // and solve flow problem
     update_flow_fields();
     eq_data_->flow_->solve_time_step(false);
+
+    // combine the new pressure with previous iterates,
+    // linear solvers start from the accelerated solution in the next iteration
+    acceleration_.accelerate(accelerated_vectors());
     
     // pass pressure to mechanics and solve mechanics
     update_potential();
@@ -338,6 +350,7 @@ void HM_Iterative::update_after_iteration()
 
 void HM_Iterative::update_after_converged()
 {
+    if (adaptive_inner_tolerance_) set_inner_tolerances(true);
     eq_data_->flow_->accept_time_step();
     eq_data_->flow_->output_data();
     eq_data_->mechanics_->output_data();
@@ -395,6 +408,24 @@ void HM_Iterative::compute_iteration_error(double& abs_error, double& rel_error)
 
 
 
+std::vector<VectorMPI *> HM_Iterative::accelerated_vectors()
+{
+    // Schur complement solution defines the residual, the full solution is reconstructed from it
+    return { &eq_data_->flow_->eq_data().p_edge_solution, &eq_data_->flow_->eq_data().full_solution };
+}
+
+
+void HM_Iterative::set_inner_tolerances(bool converged)
+{
+    // loose tolerance while the coupling error is large, input tolerances near convergence
+    const double max_inner_tolerance = 0.1, error_factor = 0.1;
+    double inner_tolerance = converged ? 0.0 : std::min(max_inner_tolerance, error_factor * rel_error_);
+    eq_data_->flow_->eq_data().lin_sys_schur->set_relative_accuracy( std::max(flow_r_tol_, inner_tolerance) );
+    eq_data_->mechanics_->eq_data().ls->set_relative_accuracy( std::max(mechanics_r_tol_, inner_tolerance) );
+}
+
+
+
 HM_Iterative::~HM_Iterative() {
 	eq_data_->flow_.reset();
     eq_data_->mechanics_.reset();
@@ -27,6 +27,7 @@
 #include "coupling/equation.hh"
 #include "flow/darcy_flow_interface.hh"
 #include "mechanics/elasticity.hh"
+#include "la/fixed_point_acceleration.hh"
 #include "system/exceptions.hh"
 
 class Mesh;
@@ -57,29 +58,54 @@ public:
                     "Absolute tolerance for difference in HM iteration." )
             .declare_key( "r_tol", it::Double(0), it::Default("1e-7"),
                     "Relative tolerance for difference in HM iteration." )
+            .declare_key( "acceleration", get_acceleration_selection(), it::Default("\"none\""),
+                    "Acceleration of the fixed point HM iteration." )
+            .declare_key( "anderson_depth", it::Integer(1), it::Default("5"),
+                    "Number of previous iterations used by the Anderson acceleration." )
+            .declare_key( "relaxation", it::Double(0), it::Default("1"),
+                    "Relaxation factor of the first HM iteration in a time step, "
+                    "initial value of the dynamic relaxation factor of the Aitken acceleration." )
+            .declare_key( "adaptive_inner_tolerance", it::Bool(), it::Default("false"),
+                    "Solve linear systems of the coupled equations inexactly, with relative tolerance "
+                    "proportional to the current difference in HM iteration. "
+                    "Tolerances given in the input of linear solvers are used near convergence." )
+            .close();
+    }
+
+    static const Input::Type::Selection &get_acceleration_selection() {
+        return it::Selection("HM_Acceleration", "Acceleration of the HM iteration.")
+            .add_value(FixedPointAcceleration::none, "none", "Plain fixed point iteration.")
+            .add_value(FixedPointAcceleration::aitken, "aitken", "Aitken dynamic relaxation.")
+            .add_value(FixedPointAcceleration::anderson, "anderson", "Anderson acceleration.")
             .close();
     }
 
     IterativeCoupling(Input::Record in_record)
-    : it(0)
+    : acceleration_(in_record.val<FixedPointAcceleration::Type>("acceleration"),
+                    in_record.val<unsigned int>("anderson_depth"),
+                    in_record.val<double>("relaxation")),
+      abs_error_(std::numeric_limits<double>::max()),
+      rel_error_(std::numeric_limits<double>::max()),
+      it(0)
     {
         min_it_ = in_record.val<unsigned int>("min_it");
         max_it_ = in_record.val<unsigned int>("max_it");
         a_tol_ = in_record.val<double>("a_tol");
         r_tol_ = in_record.val<double>("r_tol");
+        adaptive_inner_tolerance_ = in_record.val<bool>("adaptive_inner_tolerance");
     }
 
     void solve_step()
     {
         it = 0;
-        double abs_error = std::numeric_limits<double>::max();
-        double rel_error = std::numeric_limits<double>::max();
+        abs_error_ = std::numeric_limits<double>::max();
+        rel_error_ = std::numeric_limits<double>::max();
 
-        while ( it < min_it_ || (abs_error > a_tol_ && rel_error > r_tol_ && it < max_it_) )
+        while ( it < min_it_ || (abs_error_ > a_tol_ && rel_error_ > r_tol_ && it < max_it_) )
         {
             it++;
             solve_iteration();
-            compute_iteration_error(abs_error, rel_error);
+            compute_iteration_error(abs_error_, rel_error_);
             update_after_iteration();
         }
         update_after_converged();
@@ -115,6 +141,18 @@ protected:
     /// Relative tolerance for difference between two succeeding iterations.
     double r_tol_;
 
+    /// Acceleration of the fixed point iteration.
+    FixedPointAcceleration acceleration_;
+
+    /// Solve linear systems with tolerance given by the current iteration error.
+    bool adaptive_inner_tolerance_;
+
+    /// Absolute error of the last iteration.
+    double abs_error_;
+
+    /// Relative error of the last iteration.
+    double rel_error_;
+
 private:
 
     /// Iteration index.
@@ -195,6 +233,12 @@ private:
     void update_after_converged() override;
     
     void compute_iteration_error(double &abs_error, double &rel_error) override;
+
+    /// Vectors of the flow solution updated by acceleration of the iteration.
+    std::vector<VectorMPI *> accelerated_vectors();
+
+    /// Set relative tolerances of flow and mechanics solvers according to the current iteration error.
+    void set_inner_tolerances(bool converged);
     
     static const int registrar;
 
@@ -205,6 +249,12 @@ private:
 
     std::shared_ptr<EqData> eq_data_;
 
+    /// Relative tolerance of the flow linear solver given by input.
+    double flow_r_tol_;
+
+    /// Relative tolerance of the mechanics linear solver given by input.
+    double mechanics_r_tol_;
+
 };
 
 #endif /* HC_EXPLICIT_SEQUENTIAL_HH_ */
@@ -16,6 +16,7 @@
  * @author  Jan Stebel
  */
 
+#include <algorithm>
 #include "system/index_types.hh"
 #include "fem/dofhandler.hh"
 #include "fem/finite_element.hh"
@@ -175,67 +176,89 @@ void DOFHandlerMultiDim::init_status(
 }
 
 
-void DOFHandlerMultiDim::receive_ghost_dofs(unsigned int proc, vector<LongIdx> &dofs)
+void DOFHandlerMultiDim::exchange_ghost_requests(std::map<unsigned int, std::vector<LongIdx> > &requested_el)
 {
-    // send number of elements required from the other processor
-    unsigned int n_elems = ghost_proc_el[proc].size();
-    MPI_Send(&n_elems, 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD);
-    
-    // send indices of elements required
-    MPI_Send(&(ghost_proc_el[proc][0]), n_elems, MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD);
-    
-    // receive numbers of dofs on required elements
-    vector<unsigned int> n_dofs(n_elems);
-    MPI_Recv(&(n_dofs[0]), n_elems, MPI_UNSIGNED, proc, 2, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // receive dofs on required elements
-    unsigned int n_dofs_sum = 0;
-    for (auto nd : n_dofs) n_dofs_sum += nd;
-    dofs.resize(n_dofs_sum);
-    MPI_Recv(&(dofs[0]), n_dofs_sum, MPI_LONG_IDX, proc, 3, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    std::map<unsigned int, unsigned int> n_send, n_recv;
+    std::vector<MPI_Request> requests;
+    MPI_Request req;
+
+    // exchange numbers of elements required from / by the neighbouring processors
+    for (unsigned int proc : ghost_proc)
+    {
+        n_send[proc] = ghost_proc_el[proc].size();
+        n_recv[proc] = 0;
+    }
+    for (unsigned int proc : ghost_proc)
+    {
+        MPI_Irecv(&n_recv[proc], 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD, &req);
+        requests.push_back(req);
+        MPI_Isend(&n_send[proc], 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD, &req);
+        requests.push_back(req);
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    requests.clear();
+
+    // exchange indices of elements required
+    for (unsigned int proc : ghost_proc)
+        requested_el[proc].resize(n_recv[proc]);
+    for (unsigned int proc : ghost_proc)
+    {
+        MPI_Irecv(requested_el[proc].data(), n_recv[proc], MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD, &req);
+        requests.push_back(req);
+        MPI_Isend(ghost_proc_el[proc].data(), n_send[proc], MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD, &req);
+        requests.push_back(req);
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
 }
 
 
-void DOFHandlerMultiDim::send_ghost_dofs(unsigned int proc)
+void DOFHandlerMultiDim::exchange_ghost_dofs(const std::map<unsigned int, std::vector<LongIdx> > &requested_el,
+                                             std::map<unsigned int, std::vector<LongIdx> > &dofs)
 {
-    // receive number of elements required by the other processor
-    unsigned int n_elems;
-    MPI_Recv(&n_elems, 1, MPI_UNSIGNED, proc, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // receive indices of elements required
-    vector<LongIdx> elems(n_elems);
-    MPI_Recv(&(elems[0]), n_elems, MPI_LONG_IDX, proc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-    
-    // send numbers of dofs on required elements
-    vector<unsigned int> n_dofs;
-    for (LongIdx el : elems)
+    std::map<unsigned int, std::vector<LongIdx> > send_dofs;
+    std::vector<MPI_Request> requests;
+    MPI_Request req;
+
+    for (unsigned int proc : ghost_proc)
     {
-        auto cell = this->cell_accessor_from_element(el);
-        n_dofs.push_back(cell_starts[cell.local_idx()+1] - cell_starts[cell.local_idx()]);
+        // numbers of dofs on ghost elements are known locally
+        unsigned int n_dofs_sum = 0;
+        for (LongIdx el : ghost_proc_el[proc])
+        {
+            auto cell = this->cell_accessor_from_element(el);
+            n_dofs_sum += cell_starts[cell.local_idx()+1] - cell_starts[cell.local_idx()];
+        }
+        dofs[proc].resize(n_dofs_sum);
+
+        // dofs on the required elements, dofs that are not known yet are sent as INVALID_DOF
+        std::vector<LongIdx> &proc_dofs = send_dofs[proc];
+        for (LongIdx el : requested_el.at(proc))
+        {
+            auto cell = this->cell_accessor_from_element(el);
+            for (LongIdx i=cell_starts[cell.local_idx()]; i<cell_starts[cell.local_idx()+1]; i++)
+                proc_dofs.push_back( (dof_indices[i] == INVALID_DOF) ? INVALID_DOF : local_to_global_dof_idx_[dof_indices[i]] );
+        }
     }
-    MPI_Send(&(n_dofs[0]), n_elems, MPI_UNSIGNED, proc, 2, MPI_COMM_WORLD);
-    
-    // send dofs on the required elements
-    vector<LongIdx> dofs;
-    for (LongIdx el : elems)
+
+    for (unsigned int proc : ghost_proc)
     {
-        auto cell = this->cell_accessor_from_element(el);
-        for (LongIdx i=cell_starts[cell.local_idx()]; i<cell_starts[cell.local_idx()+1]; i++)
-            dofs.push_back(local_to_global_dof_idx_[dof_indices[i]]);
+        MPI_Irecv(dofs[proc].data(), dofs[proc].size(), MPI_LONG_IDX, proc, 2, MPI_COMM_WORLD, &req);
+        requests.push_back(req);
+        MPI_Isend(send_dofs[proc].data(), send_dofs[proc].size(), MPI_LONG_IDX, proc, 2, MPI_COMM_WORLD, &req);
+        requests.push_back(req);
     }
-    MPI_Send(&(dofs[0]), dofs.size(), MPI_LONG_IDX, proc, 3, MPI_COMM_WORLD);
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
 }
 
 
-void DOFHandlerMultiDim::update_local_dofs(unsigned int proc,
-                                           const std::vector<bool> &update_cells,
-                                           const std::vector<LongIdx> &dofs, 
+void DOFHandlerMultiDim::update_ghost_dofs(unsigned int proc,
+                                           const std::vector<LongIdx> &dofs,
                                            const std::vector<LongIdx> &node_dof_starts,
                                            std::vector<LongIdx> &node_dofs,
                                            const std::vector<LongIdx> &edge_dof_starts,
                                            std::vector<LongIdx> &edge_dofs)
 {
-    // update dof_indices on ghost cells
+    // update dof_indices on ghost cells, dofs received as INVALID_DOF are skipped
     unsigned int dof_offset=0;
     for (unsigned int gid=0; gid<ghost_proc_el[proc].size(); gid++)
     {
@@ -245,18 +268,19 @@ void DOFHandlerMultiDim::update_local_dofs(unsigned int proc,
         vector<unsigned int> loc_edge_dof_count(dh_cell.elm()->n_sides(), 0);
         for (unsigned int idof = 0; idof<dh_cell.n_dofs(); ++idof)
         {
+            unsigned int cell_dof_idx = cell_starts[dh_cell.local_idx()]+idof;
             if (dh_cell.cell_dof(idof).dim == 0)
             {   // update nodal dof
                 unsigned int dof_nface_idx = dh_cell.cell_dof(idof).n_face_idx;
                 unsigned int nid = mesh_->duplicate_nodes()->objects(dh_cell.dim())[mesh_->duplicate_nodes()->obj_4_el()[dh_cell.elm_idx()]].nodes[dof_nface_idx];
                 unsigned int node_dof_idx = node_dof_starts[nid]+loc_node_dof_count[dof_nface_idx];
                     
-                if (node_dofs[node_dof_idx] == INVALID_DOF)
+                if (node_dofs[node_dof_idx] == INVALID_DOF && dofs[dof_offset+idof] != INVALID_DOF)
                 {
                     node_dofs[node_dof_idx] = local_to_global_dof_idx_.size();
                     local_to_global_dof_idx_.push_back(dofs[dof_offset+idof]);
                 }
-                dof_indices[cell_starts[dh_cell.local_idx()]+idof] = node_dofs[node_dof_idx];
+                dof_indices[cell_dof_idx] = node_dofs[node_dof_idx];
                 
                 loc_node_dof_count[dof_nface_idx]++;
             }
@@ -268,24 +292,35 @@ void DOFHandlerMultiDim::update_local_dofs(unsigned int proc,
                 unsigned int eid = dh_cell.elm().side(dof_nface_idx)->edge_idx();
                 unsigned int edge_dof_idx = edge_dof_starts[eid]+loc_edge_dof_count[dof_nface_idx];
                     
-                if (edge_dofs[edge_dof_idx] == INVALID_DOF)
+                if (edge_dofs[edge_dof_idx] == INVALID_DOF && dofs[dof_offset+idof] != INVALID_DOF)
                 {
                     edge_dofs[edge_dof_idx] = local_to_global_dof_idx_.size();
                     local_to_global_dof_idx_.push_back(dofs[dof_offset+idof]);
                 }
-                dof_indices[cell_starts[dh_cell.local_idx()]+idof] = edge_dofs[edge_dof_idx];
+                dof_indices[cell_dof_idx] = edge_dofs[edge_dof_idx];
                 
                 loc_edge_dof_count[dof_nface_idx]++;
             } else if (dh_cell.cell_dof(idof).dim == dh_cell.dim())
             {
-                dof_indices[cell_starts[dh_cell.local_idx()]+idof] = local_to_global_dof_idx_.size();
-                local_to_global_dof_idx_.push_back(dofs[dof_offset+idof]);
+                if (dof_indices[cell_dof_idx] == INVALID_DOF)
+                {
+                    dof_indices[cell_dof_idx] = local_to_global_dof_idx_.size();
+                    local_to_global_dof_idx_.push_back(dofs[dof_offset+idof]);
+                }
             }
         }
         
         dof_offset += dh_cell.n_dofs();
     }
-    
+}
+
+
+void DOFHandlerMultiDim::update_local_dofs(const std::vector<bool> &update_cells,
+                                           const std::vector<LongIdx> &node_dof_starts,
+                                           const std::vector<LongIdx> &node_dofs,
+                                           const std::vector<LongIdx> &edge_dof_starts,
+                                           const std::vector<LongIdx> &edge_dofs)
+{
     // update dof_indices on local elements
     for (auto cell : this->own_range())
     {
@@ -342,6 +377,7 @@ void DOFHandlerMultiDim::distribute_dofs(std::shared_ptr<DiscreteSpace> ds)
     
     // Distribute dofs on local elements.
     dof_indices.resize(cell_starts[cell_starts.size()-1]);
+    std::fill(dof_indices.begin()+cell_starts[el_ds_->lsize()], dof_indices.end(), INVALID_DOF);
     local_to_global_dof_idx_.reserve(dof_indices.size());
     for (auto cell : this->own_range())
     {
@@ -428,31 +464,23 @@ void DOFHandlerMultiDim::distribute_dofs(std::shared_ptr<DiscreteSpace> ds)
     }
     
     // communicate dofs from ghost cells
-    // first propagate from lower procs to higher procs and then vice versa
-    for (unsigned int from_higher = 0; from_higher < 2; from_higher++)
-    {
-        for (unsigned int proc : ghost_proc)
-        {
-            if ((proc > el_ds_->myp()) == from_higher)
-            { // receive dofs from master processor
-                vector<LongIdx> dofs;
-                receive_ghost_dofs(proc, dofs);
-                
-                // update dof_indices and node_dofs on ghost elements
-                update_local_dofs(proc,
-                                  update_cells,
-                                  dofs,
-                                  node_dof_starts,
-                                  node_dofs,
-                                  edge_dof_starts,
-                                  edge_dofs
-                                 );
-                
-            }
-            else
-                send_ghost_dofs(proc);
-        }
-    }
+    // Only neighbouring processors take part, messages to all of them are exchanged at once.
+    std::map<unsigned int, std::vector<LongIdx> > requested_el, ghost_dofs;
+    exchange_ghost_requests(requested_el);
+
+    // First round: dofs on nodes/edges of own cells are set by their owner (the lowest processor
+    // having an element on the node/edge). Element of the owner is always a ghost cell.
+    exchange_ghost_dofs(requested_el, ghost_dofs);
+    for (unsigned int proc : ghost_proc)
+        update_ghost_dofs(proc, ghost_dofs[proc], node_dof_starts, node_dofs, edge_dof_starts, edge_dofs);
+    update_local_dofs(update_cells, node_dof_starts, node_dofs, edge_dof_starts, edge_dofs);
+
+    // Second round: own cells are complete on all processors, set remaining dofs on ghost cells
+    // (nodes/edges which are not shared with own cells).
+    exchange_ghost_dofs(requested_el, ghost_dofs);
+    for (unsigned int proc : ghost_proc)
+        update_ghost_dofs(proc, ghost_dofs[proc], node_dof_starts, node_dofs, edge_dof_starts, edge_dofs);
+
     update_cells.clear();
     node_dofs.clear();
     node_dof_starts.clear();
@@ -622,9 +650,19 @@ void DOFHandlerMultiDim::make_elem_partitioning()
         node_is_local[mesh_->duplicate_nodes()->objects(cell.dim())[obj_idx].nodes[nid]] = true;
     }
     
-    // create array of local ghost cells
-    for ( auto cell : mesh_->elements_range() )
+    // create array of local ghost cells, only elements sharing a node with own elements are checked
+    std::vector<unsigned int> ghost_candidates;
+    for (auto cell : this->own_range())
+        for (unsigned int nid=0; nid<cell.elm()->n_nodes(); nid++)
+        {
+            const std::vector<unsigned int> &node_elements = mesh_->node_elements()[cell.elm()->node_idx(nid)];
+            ghost_candidates.insert(ghost_candidates.end(), node_elements.begin(), node_elements.end());
+        }
+    std::sort(ghost_candidates.begin(), ghost_candidates.end());
+    ghost_candidates.erase( std::unique(ghost_candidates.begin(), ghost_candidates.end()), ghost_candidates.end() );
+    for ( unsigned int el_idx : ghost_candidates )
     {
+      ElementAccessor<3> cell = mesh_->element_accessor(el_idx);
       if (cell.proc() != el_ds_->myp())
       {
         bool has_local_node = false;
@@ -804,6 +842,7 @@ SubDOFHandlerMultiDim::SubDOFHandlerMultiDim(std::shared_ptr<DOFHandlerMultiDim>
     
     init_cell_starts();
     dof_indices.resize(cell_starts[cell_starts.size()-1]);
+    std::fill(dof_indices.begin()+cell_starts[el_ds_->lsize()], dof_indices.end(), INVALID_DOF);
     // sub_local_indices maps local dofs of parent handler to local dofs of sub-handler
     vector<LongIdx> sub_local_indices(dh->local_to_global_dof_idx_.size(), INVALID_DOF);
     map<LongIdx,LongIdx> global_to_local_dof_idx;
@@ -312,39 +312,58 @@ protected:
                      std::vector<short int> &edge_status);
     
     /**
-     * @brief Obtain dof numbers on ghost elements from other processor.
-     * @param proc  Neighbouring processor.
-     * @param dofs  Array where dofs are stored (output).
+     * @brief Exchange indices of ghost elements with neighbouring processors.
+     *
+     * Every processor sends ghost_proc_el to the owners of ghost elements.
+     * Only processors in ghost_proc are communicated (non-blocking).
+     * @param requested_el  Indices of own elements required by each neighbouring processor (output).
      */
-    void receive_ghost_dofs(unsigned int proc,
-                            std::vector<LongIdx> &dofs);
+    void exchange_ghost_requests(std::map<unsigned int, std::vector<LongIdx> > &requested_el);
 
     /**
-     * @brief Send dof numbers to other processor.
-     * @param proc  Neighbouring processor.
-     */    
-    void send_ghost_dofs(unsigned int proc);
+     * @brief Exchange dof numbers on ghost elements with all neighbouring processors at once.
+     *
+     * Dofs that are not known on the sending processor yet are sent as INVALID_DOF.
+     * @param requested_el  Indices of own elements required by each neighbouring processor.
+     * @param dofs          Dofs on ghost elements received from each neighbouring processor (output).
+     */
+    void exchange_ghost_dofs(const std::map<unsigned int, std::vector<LongIdx> > &requested_el,
+                             std::map<unsigned int, std::vector<LongIdx> > &dofs);
     
     /** 
-     * @brief Update dofs on local elements from ghost element dofs.
+     * @brief Update dofs on ghost elements of processor @p proc from received dofs.
      * 
+     * Dofs received as INVALID_DOF are skipped, they are set in the next exchange.
      * @param proc            Neighbouring processor.
-     * @param update_cells    Vector of global indices of elements which need to be updated
-     *                        from ghost elements.
      * @param dofs            Vector of dof indices on ghost elements from processor @p proc.
      * @param node_dof_starts Vector of starting indices of nodal dofs.
      * @param node_dofs       Vector of nodal dof indices (output).
      * @param edge_dof_starts Vector of starting indices of edge dofs.
      * @param edge_dofs       Vector of edge dof indices (output).
      */
-    void update_local_dofs(unsigned int proc,
-                           const std::vector<bool> &update_cells,
+    void update_ghost_dofs(unsigned int proc,
                            const std::vector<LongIdx> &dofs,
                            const std::vector<LongIdx> &node_dof_starts,
                            std::vector<LongIdx> &node_dofs,
                            const std::vector<LongIdx> &edge_dof_starts,
                            std::vector<LongIdx> &edge_dofs);
     
+    /** 
+     * @brief Update dofs on local elements from nodal and edge dofs set on ghost elements.
+     * 
+     * @param update_cells    Vector of global indices of elements which need to be updated
+     *                        from ghost elements.
+     * @param node_dof_starts Vector of starting indices of nodal dofs.
+     * @param node_dofs       Vector of nodal dof indices.
+     * @param edge_dof_starts Vector of starting indices of edge dofs.
+     * @param edge_dofs       Vector of edge dof indices.
+     */
+    void update_local_dofs(const std::vector<bool> &update_cells,
+                           const std::vector<LongIdx> &node_dof_starts,
+                           const std::vector<LongIdx> &node_dofs,
+                           const std::vector<LongIdx> &edge_dof_starts,
+                           const std::vector<LongIdx> &edge_dofs);
+    
     /**
      * @brief Communicate local dof indices to all processors and create new sequential dof handler.
      *
@@ -435,7 +454,8 @@ protected:
      * @brief Maps local and ghost dof indices to global ones.
      * 
      * First lsize_ entries correspond to dofs owned by local processor,
-     * the remaining entries are ghost dofs sorted by neighbouring processor id.
+     * the remaining entries are ghost dofs ordered by neighbouring processor id
+     * (except of dofs on nodes/edges not shared with own cells, which are appended at the end).
      */
     std::vector<LongIdx> local_to_global_dof_idx_;
     
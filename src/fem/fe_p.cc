@@ -59,6 +59,19 @@ PolynomialSpace::PolynomialSpace(unsigned int degree, unsigned int dim)
 }
 
 
+/// Integer power of @p x, avoids std::pow for small exponents of low order polynomials.
+inline double monomial_pow(double x, unsigned int n)
+{
+    switch (n)
+    {
+    case 0: return 1;
+    case 1: return x;
+    case 2: return x*x;
+    default: return std::pow(x, (int)n);
+    }
+}
+
+
 double PolynomialSpace::basis_value(unsigned int i,
                                     const arma::vec &point,
                                     unsigned int comp_index
@@ -70,7 +83,7 @@ double PolynomialSpace::basis_value(unsigned int i,
 
     double v = 1;
     for (unsigned int j=0; j<this->space_dim_; j++)
-        v *= pow(point[j], (int) powers[i][j]);
+        v *= monomial_pow(point[j], powers[i][j]);
     return v;
 }
 
@@ -92,7 +105,7 @@ const arma::vec PolynomialSpace::basis_grad(unsigned int i,
 
         for (unsigned int k=0; k<this->space_dim_; k++)
         {
-            grad[j] *= pow(p[k], (int) (k==j?powers[i][k]-1:powers[i][k]));
+            grad[j] *= monomial_pow(p[k], (k==j?powers[i][k]-1:powers[i][k]));
         }
     }
     return grad;
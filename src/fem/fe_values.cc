@@ -26,6 +26,9 @@
 #include "fem/fe_system.hh"
 #include "fem/fe_values_map.hh"
 
+#include <map>
+#include <tuple>
+
 
 
 using namespace arma;
@@ -230,6 +233,27 @@ std::shared_ptr<typename FEValues<spacedim>::FEInternalData> FEValues<spacedim>:
 {
     ASSERT( DIM == dim_ );
     ASSERT( q.dim() == DIM );
+
+    // tables are shared by all existing FEValues with the same finite element and quadrature points
+    typedef std::tuple<unsigned int, unsigned int, std::vector<double> > FEDataKey;
+    static std::map<FEDataKey, std::weak_ptr<FEInternalData> > fe_data_cache;
+    std::vector<double> points;
+    points.reserve(q.size() * DIM);
+    for (unsigned int i=0; i<q.size(); i++)
+        for (unsigned int d=0; d<DIM; d++)
+            points.push_back(q.point<DIM>(i)[d]);
+    FEDataKey key(DIM, fe.id(), points);
+    auto it = fe_data_cache.find(key);
+    if (it != fe_data_cache.end())
+    {
+        if (std::shared_ptr<FEInternalData> cached = it->second.lock()) return cached;
+    }
+
+    // drop tables that are not used anymore
+    for (auto it_exp = fe_data_cache.begin(); it_exp != fe_data_cache.end(); )
+        if (it_exp->second.expired()) it_exp = fe_data_cache.erase(it_exp);
+        else ++it_exp;
+
     std::shared_ptr<FEInternalData> data = std::make_shared<FEInternalData>(q.size(), n_dofs_);
 
     arma::mat shape_values(n_dofs_, fe.n_components());
@@ -256,7 +280,18 @@ std::shared_ptr<typename FEValues<spacedim>::FEInternalData> FEValues<spacedim>:
             data->ref_shape_grads[i][j] = grad;
         }
     }
+
+    if (fe_type_ == FEMixedSystem)
+    {
+        unsigned int comp_offset = 0;
+        for (unsigned int f=0; f<fe_sys_dofs_.size(); f++)
+        {
+            data->sub_fe_data.push_back(FEInternalData(*data, fe_sys_dofs_[f], comp_offset, fe_sys_n_components_[f]));
+            comp_offset += fe_sys_n_components_[f];
+        }
+    }
     
+    fe_data_cache[key] = data;
     return data;
 }
 
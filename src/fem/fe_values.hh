@@ -347,13 +347,21 @@ protected:
         
         /// Number of dofs (shape functions).
         unsigned int n_dofs;
+        
+        /// Data of sub-elements of FESystem, precomputed to avoid copying in every @p fill_data().
+        std::vector<FEInternalData> sub_fe_data;
     };
 
 
 
 
     
-    /// Precompute finite element data on reference element.
+    /**
+     * @brief Precompute finite element data on reference element.
+     *
+     * Data are computed once for every finite element and set of quadrature points
+     * and shared by all FEValues objects.
+     */
     template<unsigned int DIM>
     std::shared_ptr<FEInternalData> init_fe_data(const FiniteElement<DIM> &fe, const Quadrature &q);
     
@@ -230,9 +230,13 @@ public:
         unsigned int comp_offset = 0;
         for (unsigned int f=0; f<fe_values.fe_sys_dofs_.size(); f++)
         {
-            // fill fe_values for base FE
-            typename FEValues<spacedim>::FEInternalData vec_fe_data(fe_data, fe_values.fe_sys_dofs_[f], comp_offset, fe_values.fe_sys_n_components_[f]);
-            fe_values.fe_values_vec[f].fill_data(elm_values, vec_fe_data);
+            // fill fe_values for base FE, use data precomputed in init_fe_data if available
+            if (fe_data.sub_fe_data.size() == fe_values.fe_sys_dofs_.size())
+                fe_values.fe_values_vec[f].fill_data(elm_values, fe_data.sub_fe_data[f]);
+            else {
+                typename FEValues<spacedim>::FEInternalData vec_fe_data(fe_data, fe_values.fe_sys_dofs_[f], comp_offset, fe_values.fe_sys_n_components_[f]);
+                fe_values.fe_values_vec[f].fill_data(elm_values, vec_fe_data);
+            }
 
             comp_offset += fe_values.fe_sys_n_components_[f];
         }
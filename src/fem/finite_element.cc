@@ -74,6 +74,8 @@ template<unsigned int dim>
 FiniteElement<dim>::FiniteElement()
     : function_space_(nullptr)
 {
+    static unsigned int n_finite_elements = 0;
+    id_ = n_finite_elements++;
     init();
 }
 
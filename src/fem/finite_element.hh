@@ -303,6 +303,10 @@ public:
     /// Used in BDDC for unknown reason.
     virtual std::vector< arma::vec::fixed<dim+1> > dof_points() const;
 
+    /// Unique identifier of the finite element, key of shape function tables shared by FEValues objects.
+    inline unsigned int id() const
+    { return id_; }
+
     /**
      * @brief Destructor.
      */
@@ -386,6 +390,9 @@ protected:
     
     /// Set of degrees of freedom (functionals) defining the FE.
     std::vector<Dof> dofs_;
+
+    /// Unique identifier, see @p id().
+    unsigned int id_;
     
     
     friend class FESystem<dim>;
@@ -411,8 +411,8 @@ bool FieldFE<spacedim, Value>::set_time(const TimeStep &time) {
         BaseMeshReader::HeaderQuery header_query(field_name_, read_time, this->discretization_, dh_->hash());
         auto reader = ReaderCache::get_reader(reader_file_);
         auto header = reader->find_header(header_query);
-        this->input_data_cache_ = reader->template get_element_data<double>(
-            header, n_entities, n_components, bdr_shift);
+        this->input_data_cache_ = ReaderCache::get_element_data<double>(
+            reader_file_, header, n_entities, n_components, bdr_shift);
 
 		if (is_native) {
 			this->calculate_element_values();
@@ -425,6 +425,7 @@ bool FieldFE<spacedim, Value>::set_time(const TimeStep &time) {
 		} else { // DataInterpolation::interp_p0
 			this->interpolate_intersection();
 		}
+		this->input_data_cache_.reset(); // values are interpolated, data frame can be released by ReaderCache
 
 		return true;
 	} else return false;
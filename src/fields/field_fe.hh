@@ -362,7 +362,7 @@ private:
     /// Set holds data of valid / invalid element values on all regions
     std::vector<RegionValueErr> region_value_err_;
 
-    /// Input ElementDataCache is stored in set_time and used in all evaluation and interpolation methods.
+    /// Input ElementDataCache is stored in set_time and used in all interpolation methods, it is released at the end of set_time.
     ElementDataCache<double>::CacheData input_data_cache_;
 
     /// Registrar of class to factory
@@ -23,6 +23,7 @@
 #include "fields/field_python.hh"
 #include "fields/field_set.hh"
 #include "fields/python_field_proxy.hh" // TODO check if include is necessary
+#include "fields/python_field_batch.hh"
 #include <pybind11/pybind11.h>
 #include <pybind11/eval.h>
 #include <pybind11/stl.h>
@@ -153,6 +154,11 @@ void FieldPython<spacedim, Value>::cache_update(FMT_UNUSED FieldValueCache<typen
 {
     unsigned int reg_chunk_begin = cache_map.region_chunk_begin(region_patch_idx);
     unsigned int reg_chunk_end = cache_map.region_chunk_end(region_patch_idx);
+    if (PythonFieldBatch::is_active()) {
+        // evaluated later together with other python fields of the patch
+        PythonFieldBatch::add(user_class_instance_, this->field_name_, reg_chunk_begin, reg_chunk_end);
+        return;
+    }
     try {
         py::object p_func = user_class_instance_.attr("_cache_update");
         p_func(this->field_name_, reg_chunk_begin, reg_chunk_end);
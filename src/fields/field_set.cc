@@ -16,6 +16,7 @@
  */
 
 #include "fields/field_set.hh"
+#include "fields/python_field_batch.hh"
 #include "system/sys_profiler.hh"
 #include "input/flow_attribute_lib.hh"
 #include "fem/mapping_p1.hh"
@@ -219,15 +220,33 @@ bool FieldSet::is_jump_time() const {
 
 void FieldSet::cache_update(ElementCacheMap &cache_map) {
     ASSERT_GT(region_field_update_order_.size(), 0).error("Variable 'region_dependency_list' is empty. Did you call 'set_dependency' method?\n");
+    // Python fields are evaluated together in as few calls of the interpreter as possible.
+    PythonFieldBatch::start();
+    std::unordered_set<const FieldCommon *> deferred_fields; // fields of the region patch with pending python update
     for (unsigned int i_reg_patch=0; i_reg_patch<cache_map.n_regions(); ++i_reg_patch) {
-        for (const FieldCommon *field : region_field_update_order_[cache_map.region_idx_from_chunk_position(i_reg_patch)])
-            field->cache_update(cache_map, i_reg_patch);
+        unsigned int region_idx = cache_map.region_idx_from_chunk_position(i_reg_patch);
+        const std::vector<const FieldCommon *> &update_order = region_field_update_order_[region_idx];
+        const std::vector< std::vector<const FieldCommon *> > &dependencies = region_field_dependencies_[region_idx];
+        deferred_fields.clear();
+        for (unsigned int i_field=0; i_field<update_order.size(); ++i_field) {
+            for (const FieldCommon *dep_field : dependencies[i_field])
+                if (deferred_fields.find(dep_field) != deferred_fields.end()) {
+                    PythonFieldBatch::flush();
+                    deferred_fields.clear();
+                    break;
+                }
+            unsigned int n_added = PythonFieldBatch::n_added();
+            update_order[i_field]->cache_update(cache_map, i_reg_patch);
+            if (PythonFieldBatch::n_added() > n_added) deferred_fields.insert(update_order[i_field]);
+        }
     }
+    PythonFieldBatch::finish();
 }
 
 
 void FieldSet::set_dependency(FieldSet &used_fieldset) {
     region_field_update_order_.clear();
+    region_field_dependencies_.clear();
     std::unordered_set<const FieldCommon *> used_fields;
 
     for (unsigned int i_reg=0; i_reg<mesh_->region_db().size(); ++i_reg) {
@@ -247,6 +266,7 @@ void FieldSet::topological_sort(const FieldCommon *f, unsigned int i_reg, std::u
         topological_sort(f_dep, i_reg, used_fields);
     }
     region_field_update_order_[i_reg].push_back(f);
+    region_field_dependencies_[i_reg].push_back(dep_vec);
 }
 
 
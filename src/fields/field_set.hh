@@ -429,6 +429,9 @@ protected:
      */
     std::map<unsigned int, std::vector<const FieldCommon *>> region_field_update_order_;
 
+    /// Fields on which fields of @p region_field_update_order_ depend, same layout.
+    std::map<unsigned int, std::vector< std::vector<const FieldCommon *> >> region_field_dependencies_;
+
     // Default fields.
     // TODO derive from Field<>, make public, rename
 
@@ -0,0 +1,73 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    python_field_batch.cc
+ * @brief
+ */
+
+#include "fields/python_field_batch.hh"
+#include "system/python_loader.hh"
+#include "system/sys_profiler.hh"
+
+namespace py = pybind11;
+
+
+bool PythonFieldBatch::active_ = false;
+unsigned int PythonFieldBatch::n_added_ = 0;
+std::vector<PythonFieldBatch::Update> PythonFieldBatch::updates_;
+
+
+void PythonFieldBatch::start() {
+    active_ = true;
+    n_added_ = 0;
+}
+
+
+void PythonFieldBatch::finish() {
+    flush();
+    active_ = false;
+}
+
+
+void PythonFieldBatch::add(const py::object &instance, const std::string &field_name, unsigned int begin, unsigned int end) {
+    n_added_++;
+    // Merge with an update of the same field on the preceding region chunk. Not possible if some later
+    // update overlaps the added chunk, these are dependencies of the added update.
+    for (auto it = updates_.rbegin(); it != updates_.rend(); ++it) {
+        if (it->begin_ < end && begin < it->end_) break;
+        if (it->end_ == begin && it->field_name_ == field_name && it->instance_.is(instance)) {
+            it->end_ = end;
+            return;
+        }
+    }
+    updates_.push_back( {instance, field_name, begin, end} );
+}
+
+
+void PythonFieldBatch::flush() {
+    if (updates_.size() == 0) return;
+    START_TIMER("PythonFieldBatch::flush");
+
+    py::list update_list;
+    for (auto &update : updates_)
+        update_list.append( py::make_tuple(update.instance_, update.field_name_, update.begin_, update.end_) );
+    updates_.clear();
+
+    try {
+        py::object p_func = PythonLoader::load_module_by_name("flowpy").attr("PythonFieldBase").attr("_cache_update_batch");
+        p_func(update_list);
+    } catch (const py::error_already_set &ex) {
+        PythonLoader::throw_error(ex);
+    }
+    END_TIMER("PythonFieldBatch::flush");
+}
@@ -0,0 +1,75 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    python_field_batch.hh
+ * @brief
+ */
+
+#ifndef PYTHON_FIELD_BATCH_HH_
+#define PYTHON_FIELD_BATCH_HH_
+
+#include <string>
+#include <vector>
+#include <pybind11/pybind11.h>
+
+#pragma GCC visibility push(hidden)
+
+/**
+ * Collects updates of FieldPython value caches and evaluates them in one call of the interpreter.
+ *
+ * Batch is active during FieldSet::cache_update. FieldPython::cache_update only adds its region chunk
+ * to the batch, FieldSet flushes the batch before evaluation of a field that depends on some pending
+ * update and at the end of the patch. Updates are evaluated in the order they were added, updates of
+ * the same field and user class instance on adjacent region chunks are merged to a single evaluation.
+ */
+class PythonFieldBatch {
+public:
+    /// Activate batch, following updates are deferred.
+    static void start();
+
+    /// Evaluate pending updates and deactivate batch.
+    static void finish();
+
+    /// Return true if updates are deferred.
+    static inline bool is_active() {
+        return active_;
+    }
+
+    /// Add update of field @p field_name of @p instance on region chunk <@p begin, @p end).
+    static void add(const pybind11::object &instance, const std::string &field_name, unsigned int begin, unsigned int end);
+
+    /// Evaluate all pending updates in one call of PythonFieldBase._cache_update_batch.
+    static void flush();
+
+    /// Number of updates added since start, including merged ones.
+    static inline unsigned int n_added() {
+        return n_added_;
+    }
+
+private:
+    /// Pending update of one field.
+    struct Update {
+        pybind11::object instance_;
+        std::string field_name_;
+        unsigned int begin_;
+        unsigned int end_;
+    };
+
+    static bool active_;
+    static unsigned int n_added_;
+    static std::vector<Update> updates_;
+};
+
+#pragma GCC visibility pop
+
+#endif /* PYTHON_FIELD_BATCH_HH_ */
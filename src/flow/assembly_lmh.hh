@@ -300,8 +300,12 @@ protected:
                 this->loc_schur_.set_solution(eq_data_->loc_constraint_[i_constr]);
             	i_constr++;
             }
+            arma::mat inv_a = eq_data_->inv_a_block(dh_cell.local_idx(), dh_cell.dim());
+            if (!eq_data_->local_blocks_valid_)
+                eq_data_->loc_system_[dh_cell.local_idx()].compute_inverse_block(
+                        eq_data_->schur_offset_[dh_cell.dim()-1], inv_a);
             eq_data_->loc_system_[dh_cell.local_idx()].compute_schur_complement(
-                    eq_data_->schur_offset_[dh_cell.dim()-1], this->loc_schur_, true);
+                    eq_data_->schur_offset_[dh_cell.dim()-1], inv_a, this->loc_schur_, true);
 
             // for seepage BC, save local system
             if (eq_data_->save_local_system_[dh_cell.local_idx()])
@@ -341,7 +345,7 @@ protected:
             arma::vec schur_solution = this->eq_data_->p_edge_solution.get_subvec(this->loc_schur_.row_dofs);
             // reconstruct the velocity and pressure
             this->eq_data_->loc_system_[this->bulk_local_idx_].reconstruct_solution_schur(this->eq_data_->schur_offset_[dh_cell.dim()-1],
-                                                                                  schur_solution, this->reconstructed_solution_);
+                    this->eq_data_->inv_a_block(this->bulk_local_idx_, dh_cell.dim()), schur_solution, this->reconstructed_solution_);
 
             this->reconstructed_solution_ += this->eq_data_->postprocess_solution_[this->bulk_local_idx_];
 
@@ -372,6 +376,9 @@ protected:
                            * fe_values_.JxW(k);
                 eq_data_->loc_system_[bulk_local_idx_].add_value(i, rhs_val);
 
+                // block A is replaced by its kept inverse
+                if (eq_data_->local_blocks_valid_) continue;
+
                 for (unsigned int j=0; j<fe_values_.n_dofs(); j++){
                     double mat_val =
                         arma::dot( velocity.value(i,k), //TODO: compute anisotropy before
@@ -702,7 +709,8 @@ protected:
             auto loc_dof_vec = cr_cell.get_loc_dof_indices();
             arma::vec schur_solution = eq_data_->p_edge_solution.get_subvec(loc_dof_vec);
             // reconstruct the velocity and pressure
-            ls->second.reconstruct_solution_schur(eq_data_->schur_offset_[dim-1], schur_solution, reconstructed_solution_);
+            ls->second.reconstruct_solution_schur(eq_data_->schur_offset_[dim-1],
+                    eq_data_->inv_a_block(dh_cell.local_idx(), dim), schur_solution, reconstructed_solution_);
 
         	unsigned int pos_in_cache = this->element_cache_map_->position_in_cache(dh_cell.elm_idx());
         	auto p = *( this->bulk_points(pos_in_cache).begin() );
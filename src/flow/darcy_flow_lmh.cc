@@ -19,6 +19,7 @@
 
 //#include <limits>
 #include <vector>
+#include <cmath>
 //#include <iostream>
 //#include <iterator>
 //#include <algorithm>
@@ -117,6 +118,19 @@ const it::Record & DarcyLMH::get_input_type() {
             "If a stagnation of the nonlinear solver is detected the solver stops. "
             "A divergence is reported by default, forcing the end of the simulation. By setting this flag to 'true', the solver "
             "ends with convergence success on stagnation, but it reports warning about it.")
+        .declare_key("reuse_preconditioner", it::Bool(), it::Default("false"),
+            "Keep the preconditioner of the linear solver from the previous nonlinear iteration "
+            "as long as the residual decreases at least by the factor 'reuse_rate' per iteration. "
+            "The matrix is still assembled in every iteration, since it is necessary for the residual. "
+            "Supported only by the PETSc linear solver.")
+        .declare_key("reuse_rate", it::Double(0.0, 1.0), it::Default("0.5"),
+            "Maximal ratio of residuals of two successive nonlinear iterations that allows to keep the preconditioner.")
+        .declare_key("adaptive_linear_tolerance", it::Bool(), it::Default("false"),
+            "Set the relative tolerance of the linear solver in every nonlinear iteration by the Eisenstat-Walker rule, "
+            "i.e. solve the linear system only as precisely as the current nonlinear residual requires. "
+            "The value of 'r_tol' given in the linear solver record takes precedence.")
+        .declare_key("max_linear_tolerance", it::Double(0.0, 1.0), it::Default("0.1"),
+            "Upper bound of the adaptive relative tolerance of the linear solver.")
         .close();
 
     DarcyLMH::EqFields eq_fields;
@@ -144,6 +158,10 @@ const it::Record & DarcyLMH::get_input_type() {
                 "Settings for computing mass balance.")
 		.declare_key("mortar_method", get_mh_mortar_selection(), it::Default("\"None\""),
 				"Method for coupling Darcy flow between dimensions on incompatible meshes. [Experimental]" )
+		.declare_key("reuse_local_blocks", it::Bool(), it::Default("false"),
+				"Keep inverses of velocity blocks of local systems between assemblies until the fields "
+				"'conductivity', 'anisotropy', 'cross_section' or 'sigma' change. "
+				"Not suitable if these fields depend on solution of other equations. Ignored by the Richards model.")
 		.close();
 }
 
@@ -349,6 +367,7 @@ const it::Selection & DarcyLMH::EqFields::get_bc_type_selection() {
 
 
 DarcyLMH::EqData::EqData()
+: local_blocks_valid_(false)
 {
     mortar_method_=NoMortar;
 }
@@ -361,6 +380,16 @@ void DarcyLMH::EqData::init()
     bc_fluxes_reconstruted.resize(size);
     loc_system_.resize(size);
     postprocess_solution_.resize(size);
+
+    // block A of cell of dimension dim has (dim+1) side DOFs and one element DOF
+    inv_a_block_pos_.resize(size);
+    unsigned int pos = 0;
+    for ( DHCellAccessor dh_cell : dh_->own_range() ) {
+        inv_a_block_pos_[dh_cell.local_idx()] = pos;
+        pos += (dh_cell.dim()+2) * (dh_cell.dim()+2);
+    }
+    inv_a_blocks_.resize(pos);
+    local_blocks_valid_ = false;
 }
 
 
@@ -391,6 +420,7 @@ DarcyLMH::DarcyLMH(Mesh &mesh_in, const Input::Record in_rec, TimeGovernor *tm)
 : DarcyFlowInterface(mesh_in, in_rec),
     output_object(nullptr),
     data_changed_(false),
+    reuse_local_blocks_(false),
 	read_init_cond_assembly_(nullptr),
 	mh_matrix_assembly_(nullptr),
 	reconstruct_schur_assembly_(nullptr)
@@ -437,6 +467,15 @@ DarcyLMH::DarcyLMH(Mesh &mesh_in, const Input::Record in_rec, TimeGovernor *tm)
     
 }
 
+bool DarcyLMH::set_eq_fields_time(LimitSide limit_side)
+{
+    bool changed = eq_fields_->set_time(time_->step(), limit_side);
+    if (eq_fields_->anisotropy.changed() || eq_fields_->conductivity.changed()
+            || eq_fields_->cross_section.changed() || eq_fields_->sigma.changed())
+        eq_data_->local_blocks_valid_ = false;
+    return changed;
+}
+
 double DarcyLMH::solved_time()
 {
     // DebugOut() << "t = " << time_->t() << " step_end " << time_->step().end() << "\n";
@@ -590,6 +629,7 @@ void DarcyLMH::initialize() {
 
 
     eq_data_->nonlinear_iteration_=0;
+    reuse_local_blocks_ = input_record_.val<bool>("reuse_local_blocks");
     Input::AbstractRecord rec = this->input_record_
             .val<Input::Record>("nonlinear_solver")
             .val<Input::AbstractRecord>("linear_solver");
@@ -597,7 +637,7 @@ void DarcyLMH::initialize() {
     initialize_specific();
     
     // auxiliary set_time call  since allocation assembly evaluates fields as well
-    data_changed_ = eq_fields_->set_time(time_->step(), LimitSide::right) || data_changed_;
+    data_changed_ = set_eq_fields_time(LimitSide::right) || data_changed_;
     create_linear_system(rec);
 
 
@@ -665,7 +705,7 @@ void DarcyLMH::zero_time_step()
      *   Solver should be able to switch from and to steady case depending on the zero time term.
      */
 
-    data_changed_ = eq_fields_->set_time(time_->step(), LimitSide::right) || data_changed_;
+    data_changed_ = set_eq_fields_time(LimitSide::right) || data_changed_;
 
     // zero_time_term means steady case
     eq_data_->use_steady_assembly_ = zero_time_term();
@@ -715,7 +755,7 @@ void DarcyLMH::update_solution()
 
 void DarcyLMH::solve_time_step(bool output)
 {
-    data_changed_ = eq_fields_->set_time(time_->step(), LimitSide::left) || data_changed_;
+    data_changed_ = set_eq_fields_time(LimitSide::left) || data_changed_;
     bool zero_time_term_from_left=zero_time_term();
 
     bool jump_time = eq_fields_->storativity.is_jump_time();
@@ -745,7 +785,7 @@ void DarcyLMH::solve_time_step(bool output)
         return;
     }
 
-    data_changed_ = eq_fields_->set_time(time_->step(), LimitSide::right) || data_changed_;
+    data_changed_ = set_eq_fields_time(LimitSide::right) || data_changed_;
     bool zero_time_term_from_right=zero_time_term();
     if (zero_time_term_from_right) {
         MessageOut() << "Flow time step - steady case\n";
@@ -798,6 +838,13 @@ void DarcyLMH::solve_nonlinear()
     }
     vector<double> convergence_history;
 
+    bool reuse_preconditioner = nl_solver_rec.val<bool>("reuse_preconditioner");
+    double reuse_rate = nl_solver_rec.val<double>("reuse_rate");
+    bool adaptive_linear_tolerance = nl_solver_rec.val<bool>("adaptive_linear_tolerance");
+    double max_linear_tolerance = nl_solver_rec.val<double>("max_linear_tolerance");
+    double linear_tolerance = max_linear_tolerance;
+    unsigned int n_linear_it = 0, n_reused_pc = 0;
+
     while (eq_data_->nonlinear_iteration_ < this->min_n_it_ ||
            (residual_norm > this->tolerance_ &&  eq_data_->nonlinear_iteration_ < this->max_n_it_ )) {
     	ASSERT_EQ( convergence_history.size(), eq_data_->nonlinear_iteration_ );
@@ -817,10 +864,25 @@ void DarcyLMH::solve_nonlinear()
             }
         }
 
+        START_TIMER("DarcyLMH::nonlinear_iteration");
         if (! is_linear_common){
         	eq_data_->p_edge_solution_previous.copy_from(eq_data_->p_edge_solution);
         	eq_data_->p_edge_solution_previous.local_to_ghost_begin();
         	eq_data_->p_edge_solution_previous.local_to_ghost_end();
+
+        	unsigned int n_hist = convergence_history.size();
+        	if (adaptive_linear_tolerance) {
+        	    if (n_hist > 1)
+        	        linear_tolerance = eisenstat_walker_tolerance(linear_tolerance, max_linear_tolerance,
+        	                this->tolerance_, convergence_history[n_hist-2], residual_norm);
+        	    lin_sys_schur().set_tolerances(linear_tolerance, 0.01*this->tolerance_, 10000, 100);
+        	}
+
+        	// modified Picard iteration: keep the preconditioner while the convergence is fast enough
+        	bool keep_pc = reuse_preconditioner && n_hist > 1
+        	        && residual_norm < reuse_rate * convergence_history[n_hist-2];
+        	lin_sys_schur().set_reuse_preconditioner(keep_pc);
+        	if (keep_pc) n_reused_pc++;
         }
 
         LinSys::SolveInfo si = lin_sys_schur().solve();
@@ -828,6 +890,7 @@ void DarcyLMH::solve_nonlinear()
         		si.n_iterations, si.converged_reason, lin_sys_schur().compute_residual());
         
         eq_data_->nonlinear_iteration_++;
+        n_linear_it += si.n_iterations;
 
         // hack to make BDDC work with empty compute_residual
         if (is_linear_common){
@@ -850,6 +913,10 @@ void DarcyLMH::solve_nonlinear()
         MessageOut().fmt("[nonlinear solver] it: {} lin. it: {}, reason: {}, residual: {}\n",
                 eq_data_->nonlinear_iteration_, si.n_iterations, si.converged_reason, residual_norm);
     }
+    lin_sys_schur().set_reuse_preconditioner(false);
+    if (! is_linear_common)
+        MessageOut().fmt("[nonlinear solver] total it: {}, lin. it: {}, reused preconditioners: {}\n",
+                eq_data_->nonlinear_iteration_, n_linear_it, n_reused_pc);
     
 //    reconstruct_solution_from_schur(eq_data_->multidim_assembler);
     START_TIMER("DarcyFlowMH::reconstruct_solution_from_schur");
@@ -868,6 +935,21 @@ void DarcyLMH::solve_nonlinear()
 }
 
 
+double DarcyLMH::eisenstat_walker_tolerance(double last_tolerance, double max_tolerance,
+        double nonlinear_tolerance, double last_residual, double residual)
+{
+    // Eisenstat-Walker choice 2 with gamma = 0.9, alpha = 2 and its safeguard
+    const double gamma = 0.9, alpha = 2.0;
+    double tolerance = gamma * std::pow(residual / last_residual, alpha);
+    double safeguard = gamma * std::pow(last_tolerance, alpha);
+    if (safeguard > 0.1) tolerance = std::max(tolerance, safeguard);
+    tolerance = std::min(tolerance, max_tolerance);
+    // do not oversolve near the nonlinear tolerance
+    if (residual > 0.0) tolerance = std::max(tolerance, 0.5 * nonlinear_tolerance / residual);
+    return std::min(tolerance, max_tolerance);
+}
+
+
 void DarcyLMH::accept_time_step()
 {
 	eq_data_->p_edge_solution_previous_time.copy_from(eq_data_->p_edge_solution);
@@ -1280,6 +1362,9 @@ void DarcyLMH::assembly_linear_system() {
         END_TIMER("DarcyLMH::assembly_steady_mh_matrix");
 //        assembly_mh_matrix( eq_data_->multidim_assembler ); // fill matrix
 
+        // inverses of blocks A computed in this assembly are kept for the next ones
+        eq_data_->local_blocks_valid_ = reuse_local_blocks_;
+
         lin_sys_schur().finish_assembly();
         lin_sys_schur().set_matrix_changed();
 
@@ -279,6 +279,21 @@ public:
         std::vector<bool> save_local_system_;       ///< Flag for saving the local system. Currently used only in case of seepage BC.
         std::vector<bool> bc_fluxes_reconstruted;   ///< Flag indicating whether the fluxes for seepage BC has been reconstructed already.
         std::array<unsigned int, 3> schur_offset_;  ///< Index offset in the local system for the Schur complement (of dim = 1,2,3).
+
+        /**
+         * Inverses of blocks A (sides and element DOFs) of local systems of own cells, stored contiguously.
+         * Computed in every assembly unless @p local_blocks_valid_ is set, used in Schur complement
+         * and in reconstruction of the solution.
+         */
+        std::vector<double> inv_a_blocks_;
+        std::vector<unsigned int> inv_a_block_pos_; ///< Position of the block of a cell (given by local idx) in @p inv_a_blocks_.
+        bool local_blocks_valid_;                   ///< Blocks A are not assembled, the kept inverses are used instead.
+
+        /// Return view to the inverse of block A of the local system of the given cell.
+        inline arma::mat inv_a_block(unsigned int local_idx, unsigned int dim)
+        {
+            return arma::mat(&inv_a_blocks_[ inv_a_block_pos_[local_idx] ], dim+2, dim+2, false, true);
+        }
     };
 
     /// Selection for enum MortarMethod.
@@ -320,6 +335,15 @@ public:
     void set_extra_source(const Field<3, FieldValue<3>::Scalar> &extra_src)
     { eq_fields_->extra_source = extra_src; }
 
+    /**
+     * Relative tolerance of the linear solver for the next nonlinear iteration (Eisenstat-Walker, choice 2).
+     * @p last_tolerance tolerance used in the last iteration, @p last_residual, @p residual nonlinear residuals
+     * before and after the last iteration. The result is bounded by @p max_tolerance and it is not smaller
+     * than necessary to reach @p nonlinear_tolerance.
+     */
+    static double eisenstat_walker_tolerance(double last_tolerance, double max_tolerance,
+            double nonlinear_tolerance, double last_residual, double residual);
+
     virtual ~DarcyLMH() override;
 
 
@@ -381,6 +405,9 @@ protected:
      */
     virtual void assembly_linear_system();
 
+    /// Set time of equation fields, invalidate kept inverses of local blocks if fields they depend on changed.
+    bool set_eq_fields_time(LimitSide limit_side);
+
 //     void set_mesh_data_for_bddc(LinSys_BDDC * bddc_ls);
     /**
      * Return a norm of residual vector.
@@ -413,6 +440,9 @@ protected:
 
 	bool data_changed_;
 
+	/// Keep inverses of blocks A of local systems until some of fields they depend on change.
+	bool reuse_local_blocks_;
+
 	// Setting of the nonlinear solver. TODO: Move to the solver class later on.
 	double tolerance_;
 	unsigned int min_n_it_;
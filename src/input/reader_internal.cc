@@ -42,6 +42,8 @@ StorageBase * ReaderInternal::make_sub_storage(PathBase &p, const Type::Array *a
 {
 	int arr_size;
 	if ( (arr_size = p.get_array_size()) != -1 ) {
+		if (typeid(array->get_sub_type()) == typeid(Type::Double))
+			return this->make_double_array_storage(p, array, arr_size);
 		return this->make_array_storage(p, array, arr_size);
 	} else if (p.get_record_tag() == "include") {
 		return make_include_storage(p, array);
@@ -54,6 +56,35 @@ StorageBase * ReaderInternal::make_sub_storage(PathBase &p, const Type::Array *a
 	}
 }
 
+StorageBase * ReaderInternal::make_double_array_storage(PathBase &p, const Type::Array *array, int arr_size)
+{
+	ASSERT(p.is_array_type()).error();
+
+	// error message of wrong size
+	if ( !array->match_size( arr_size ) ) return this->make_array_storage(p, array, arr_size);
+
+	const Type::Double *double_type = static_cast<const Type::Double *>( &(array->get_sub_type()) );
+	StorageDoubleArray *storage_array = new StorageDoubleArray(arr_size);
+	for( int idx=0; idx < arr_size; idx++)  {
+		p.down(idx);
+		PathBase * ref_path = p.find_ref_node();
+		if (ref_path || p.is_null_type()) {
+			delete ref_path;
+			p.up();
+			delete storage_array;
+			return this->make_array_storage(p, array, arr_size);
+		}
+		double value = read_double_value(p, double_type);
+		if (! double_type->match(value)) {
+			delete storage_array;
+			this->generate_input_error(p, double_type, "Value out of bounds.", false);
+		}
+		storage_array->set_value(idx, value);
+		p.up();
+	}
+	return storage_array;
+}
+
 StorageBase * ReaderInternal::make_sub_storage(PathBase &p, const Type::Selection *selection)
 {
     string item_name = read_string_value(p, selection);
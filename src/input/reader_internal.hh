@@ -53,6 +53,12 @@ protected:
     StorageBase * make_sub_storage(PathBase &p, const Type::Double *double_type) override;    ///< Create storage of Type::Double type
     StorageBase * make_sub_storage(PathBase &p, const Type::String *string_type) override;    ///< Create storage of Type::String type
 
+    /**
+     * Create compact storage of Type::Array of Type::Double values. Falls back to @p make_array_storage
+     * if some item is a reference or null.
+     */
+    StorageBase * make_double_array_storage(PathBase &p, const Type::Array *array, int arr_size);
+
 };
 
 
@@ -256,6 +256,62 @@ StorageDouble::~StorageDouble()
 
 
 
+/**********************************************
+ * Implementation of StorageDoubleArray
+ */
+
+StorageDoubleArray::StorageDoubleArray(unsigned int size)
+: array_(size, StorageDouble(0.0))
+{}
+
+
+
+void StorageDoubleArray::set_value(unsigned int index, double value) {
+	ASSERT_LT(index, array_.size()).error("Index is out of array.");
+    array_[index] = StorageDouble(value);
+}
+
+
+
+StorageBase * StorageDoubleArray::get_item(const unsigned int index) const {
+	ASSERT_LT(index, array_.size()).error("Index is out of array.");
+    return const_cast<StorageDouble *>( &(array_[index]) );
+}
+
+
+
+unsigned int StorageDoubleArray::get_array_size() const {
+    return array_.size();
+}
+
+
+
+bool StorageDoubleArray::is_null() const {
+    return false;
+}
+
+
+
+StorageBase * StorageDoubleArray::deep_copy() const {
+    StorageDoubleArray *copy = new StorageDoubleArray(0);
+    copy->array_ = array_;
+    return copy;
+}
+
+
+
+void StorageDoubleArray::print(ostream &stream, int pad)  const {
+    stream << setw(pad) << "" << "array(" << this->get_array_size() << ")" << std::endl;
+    for(unsigned int i=0;i<get_array_size();++i) array_[i].print(stream, pad+2);
+}
+
+
+
+StorageDoubleArray::~StorageDoubleArray()
+{}
+
+
+
 /**********************************************
  * Implementation of StorageString
  */
@@ -144,6 +144,24 @@ private:
     double value_;
 };
 
+/**
+ * Compact array of doubles. Items are stored in one contiguous block instead of separately allocated nodes,
+ * used for large numeric arrays of the input (tables of time functions, points, ...).
+ */
+class StorageDoubleArray : public StorageBase {
+public:
+    StorageDoubleArray(unsigned int size);
+    void set_value(unsigned int index, double value);
+    virtual StorageBase * get_item(const unsigned int index) const;
+    virtual unsigned int get_array_size() const;
+    virtual bool is_null() const;
+    virtual StorageBase *deep_copy() const;
+    virtual void print(std::ostream &stream, int pad=0) const;
+    virtual ~StorageDoubleArray();
+private:
+    std::vector<StorageDouble> array_;
+};
+
 class StorageString : public StorageBase {
 public:
     StorageString(const std::string & value);
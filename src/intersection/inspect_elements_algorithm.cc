@@ -116,6 +116,94 @@ bool InspectElementsAlgorithm<dim>::compute_initial_CI(const ElementAccessor<3>
 
 
 
+/**
+ * Returns true if the signed Plucker products @p w of a line and sides of a triangle
+ * have both signs, i.e. the line misses the triangle. Zero products (up to tolerance) are
+ * never considered as a miss, the absolute tolerance @p tol_abs must be at least the scaled
+ * epsilon of ComputeIntersection<1,2>.
+ */
+static inline bool plucker_line_misses(double w0, double w1, double w2, double tol_abs)
+{
+    double tol = 2 * geometry_epsilon * (std::fabs(w0) + std::fabs(w1) + std::fabs(w2)) + tol_abs;
+    double w_max = std::max(w0, std::max(w1, w2));
+    double w_min = std::min(w0, std::min(w1, w2));
+    return (w_max > tol) && (w_min < -tol);
+}
+
+
+template<unsigned int dim>
+void InspectElementsAlgorithm<dim>::filter_candidates(const ElementAccessor<3> &comp_ele,
+                                                      const std::vector<unsigned int> &candidates,
+                                                      std::vector<bool> &no_intersection)
+{
+    START_TIMER("Plucker candidate filter");
+    no_intersection.assign(candidates.size(), false);
+
+    // Plucker coordinates of edges of candidate tetrahedra
+    std::vector<unsigned int> tetrahedra;
+    tetrahedra.reserve(candidates.size());
+    candidate_edges_.clear();
+    candidate_edges_.reserve(RefElement<3>::n_lines * candidates.size());
+    for (unsigned int i=0; i < candidates.size(); i++) {
+        ElementAccessor<3> ele_3D = mesh->element_accessor( candidates[i] );
+        if (ele_3D.dim() != 3) continue;
+        tetrahedra.push_back(i);
+        for(unsigned int line = 0; line < RefElement<3>::n_lines; line++)
+            candidate_edges_.add(*ele_3D.node(RefElement<3>::interact(Interaction<0,1>(line))[0]),
+                                 *ele_3D.node(RefElement<3>::interact(Interaction<0,1>(line))[1]));
+    }
+    if (tetrahedra.size() == 0) {
+        END_TIMER("Plucker candidate filter");
+        return;
+    }
+
+    // products of lines of component element with all edges
+    double comp_scale = 0;
+    for(unsigned int line = 0; line < RefElement<dim>::n_lines; line++) {
+        Plucker pl(*comp_ele.node(RefElement<dim>::interact(Interaction<0,1>(line))[0]),
+                   *comp_ele.node(RefElement<dim>::interact(Interaction<0,1>(line))[1]), true);
+        comp_scale = std::max(comp_scale, pl.scale());
+        candidate_edges_.products(pl, candidate_products_[line]);
+    }
+
+    for (unsigned int k=0; k < tetrahedra.size(); k++) {
+        const unsigned int first_edge = k * RefElement<3>::n_lines;
+        double scale = comp_scale;
+        for(unsigned int line = 0; line < RefElement<3>::n_lines; line++)
+            scale = std::max(scale, candidate_edges_.scale(first_edge + line));
+        double tol_abs = 2 * geometry_epsilon * scale * scale * scale;
+
+        // lines of component element vs faces of tetrahedron (as in ComputeIntersection<1,3>)
+        bool miss = true;
+        for(unsigned int comp_line = 0; comp_line < RefElement<dim>::n_lines && miss; comp_line++) {
+            const double *p = candidate_products_[comp_line].data() + first_edge;
+            for(unsigned int face = 0; face < RefElement<3>::n_sides && miss; face++) {
+                double w[3];
+                for(unsigned int j = 0; j < RefElement<3>::n_lines_per_side; j++) {
+                    double product = p[RefElement<3>::interact(Interaction<1,2>(face))[j]];
+                    w[j] = RefElement<2>::normal_orientation(j) ? -product : product;
+                }
+                miss = plucker_line_misses(w[0], w[1], w[2], tol_abs);
+            }
+        }
+
+        // edges of tetrahedron vs triangle (as in ComputeIntersection<2,3>)
+        if (dim == 2)
+            for(unsigned int line = 0; line < RefElement<3>::n_lines && miss; line++) {
+                double w[3];
+                for(unsigned int side = 0; side < RefElement<dim>::n_lines; side++) {
+                    double product = candidate_products_[side][first_edge + line];
+                    w[side] = RefElement<2>::normal_orientation(side) ? -product : product;
+                }
+                miss = plucker_line_misses(w[0], w[1], w[2], tol_abs);
+            }
+
+        no_intersection[ tetrahedra[k] ] = miss;
+    }
+    END_TIMER("Plucker candidate filter");
+}
+
+
 template<unsigned int dim>
 bool InspectElementsAlgorithm<dim>::intersection_exists(unsigned int component_ele_idx, unsigned int bulk_ele_idx) 
 {
@@ -160,12 +248,15 @@ void InspectElementsAlgorithm<dim>::compute_intersections(const BIHTree& bih)
             bih.find_bounding_box(bih.ele_bounding_box(component_ele_idx), searchedElements);
             END_TIMER("BIHtree find");
 
+            std::vector<bool> no_intersection;
+            filter_candidates(elm, searchedElements, no_intersection);
+
             START_TIMER("Bounding box element iteration");
             
             // Go through all element which bounding box intersects the component element bounding box
-            for (std::vector<unsigned int>::iterator it = searchedElements.begin(); it!=searchedElements.end(); it++)
+            for (unsigned int i_candidate = 0; i_candidate < searchedElements.size(); i_candidate++)
             {
-                unsigned int bulk_ele_idx = *it;
+                unsigned int bulk_ele_idx = searchedElements[i_candidate];
                 ElementAccessor<3> ele_3D = mesh->element_accessor( bulk_ele_idx );
 
                 // if:
@@ -176,6 +267,11 @@ void InspectElementsAlgorithm<dim>::compute_intersections(const BIHTree& bih)
                     (last_slave_for_3D_elements[bulk_ele_idx] != component_ele_idx &&
                      !intersection_exists(component_ele_idx,bulk_ele_idx) )
                 ) {
+                    // rejected by the Plucker filter, same as empty result of compute_initial_CI
+                    if (no_intersection[i_candidate]) {
+                        last_slave_for_3D_elements[bulk_ele_idx] = component_ele_idx;
+                        continue;
+                    }
                     
                         // - find first intersection
                         // - if found, prolongate and possibly fill both prolongation queues
@@ -283,15 +379,18 @@ void InspectElementsAlgorithm<dim>::compute_intersections_BIHtree(const BIHTree&
             bih.find_bounding_box(bih.ele_bounding_box(component_ele_idx), searchedElements);
             END_TIMER("BIHtree find");
             
+            std::vector<bool> no_intersection;
+            filter_candidates(elm, searchedElements, no_intersection);
+
             START_TIMER("Bounding box element iteration");
             
             // Go through all element which bounding box intersects the component element bounding box
-            for (std::vector<unsigned int>::iterator it = searchedElements.begin(); it!=searchedElements.end(); it++)
+            for (unsigned int i_candidate = 0; i_candidate < searchedElements.size(); i_candidate++)
             {
-                unsigned int bulk_ele_idx = *it;
+                unsigned int bulk_ele_idx = searchedElements[i_candidate];
                 ElementAccessor<3> ele_3D = mesh->element_accessor( bulk_ele_idx );
                 
-                if (ele_3D.dim() == 3
+                if (ele_3D.dim() == 3 && !no_intersection[i_candidate]
                 ) {
                     
                     IntersectionAux<dim,3> is(component_ele_idx, bulk_ele_idx);
@@ -21,6 +21,8 @@
 #define INSPECT_ELEMENTS_ALGORITHM_H_
 
 #include "mesh/bounding_box.hh"
+#include "mesh/ref_element.hh"
+#include "intersection/plucker.hh"
 
 // #include "simplex.hh"
 
@@ -150,6 +152,11 @@ private:
     /// Resulting vector of intersections.
     std::vector<std::vector<IntersectionAux<dim,3>>> intersection_list_;
     
+    /// Plucker coordinates of edges of candidate tetrahedra (6 consecutive lines per tetrahedron).
+    PluckerBatch candidate_edges_;
+    /// Plucker products of lines of component element with @p candidate_edges_, one vector per line.
+    std::vector<double> candidate_products_[RefElement<dim>::n_lines];
+    
     /// Initialization.
     /// Sets vector sizes and computes bulk bounding box.
     void init();
@@ -162,6 +169,20 @@ private:
     /// A hard way to find whether the intersection of two elements has already been computed, or not.
     bool intersection_exists(unsigned int component_ele_idx, unsigned int bulk_ele_idx);
     
+    /** @brief Marks candidate bulk elements that certainly do not intersect the component element.
+     *
+     * Plucker products of the component element lines with edges of all candidate tetrahedra
+     * are evaluated in a batch. The candidate is rejected if the lines of the component element
+     * miss all faces of the tetrahedron and (for triangle) the tetrahedron edges miss the triangle,
+     * with tolerances not smaller than in ComputeIntersection. Rejected candidates would
+     * give empty intersection.
+     * @param comp_ele        Component element.
+     * @param candidates      Indices of candidate bulk elements (from BIH).
+     * @param no_intersection Output, true for rejected candidates.
+     */
+    void filter_candidates(const ElementAccessor<3> &comp_ele, const std::vector<unsigned int> &candidates,
+                           std::vector<bool> &no_intersection);
+    
     /// Computes the first intersection, from which we then prolongate.
     bool compute_initial_CI(const ElementAccessor<3> &comp_ele, const ElementAccessor<3> &bulk_ele);
     
@@ -49,6 +49,49 @@ void Plucker::compute(){
     computed_ = true;
 }
 
+void PluckerBatch::clear()
+{
+    for (auto &c : coords_) c.clear();
+    scale_.clear();
+}
+
+
+void PluckerBatch::reserve(unsigned int n)
+{
+    for (auto &c : coords_) c.reserve(n);
+    scale_.reserve(n);
+}
+
+
+void PluckerBatch::add(const Point &a, const Point &b)
+{
+    double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    coords_[0].push_back(u[0]);
+    coords_[1].push_back(u[1]);
+    coords_[2].push_back(u[2]);
+    coords_[3].push_back(u[1]*a[2] - u[2]*a[1]);
+    coords_[4].push_back(u[2]*a[0] - u[0]*a[2]);
+    coords_[5].push_back(u[0]*a[1] - u[1]*a[0]);
+    scale_.push_back( std::max( std::fabs(u[0]), std::max(std::fabs(u[1]), std::fabs(u[2])) ) );
+}
+
+
+void PluckerBatch::products(const Plucker &line, std::vector<double> &result) const
+{
+    ASSERT(line.is_computed());
+    const double l0 = line[0], l1 = line[1], l2 = line[2], l3 = line[3], l4 = line[4], l5 = line[5];
+    const double *u0 = coords_[0].data(), *u1 = coords_[1].data(), *u2 = coords_[2].data(),
+                 *m0 = coords_[3].data(), *m1 = coords_[4].data(), *m2 = coords_[5].data();
+    unsigned int n = size();
+    result.resize(n);
+    double *res = result.data();
+
+    // same order of operations as Plucker::operator*
+    for (unsigned int i=0; i<n; ++i)
+        res[i] = (l0*m0[i]) + (l1*m1[i]) + (l2*m2[i]) + (l3*u0[i]) + (l4*u1[i]) + (l5*u2[i]);
+}
+
+
 ostream& operator<<(ostream& os, const Plucker& p)
 {
     if(p.computed_){
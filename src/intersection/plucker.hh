@@ -18,7 +18,9 @@
  */
 
 #include <armadillo>
+#include <array>
 #include <iostream>
+#include <vector>
 #include "system/system.hh"
 #include "system/armor.hh"
 #include "mesh/point.hh"
@@ -109,6 +111,48 @@ public:
 /// Operator for printing Plucker coordinates.
 std::ostream& operator<<(std::ostream& os, const Plucker& p);
 
+
+/** @brief Plucker coordinates of a set of lines stored in SoA layout.
+ *
+ * Evaluates products of a single line with all lines of the batch (e.g. with edges
+ * of all candidate tetrahedra) in a single loop over contiguous arrays, that is vectorized
+ * by the compiler. Coordinates and products are computed by the same formulas
+ * as in class Plucker, so the products are equal to @p Plucker::operator*.
+ */
+class PluckerBatch {
+public:
+	typedef typename Space<3>::Point Point;
+
+	/// Remove all lines, keep allocated memory.
+	void clear();
+
+	/// Reserve memory for @p n lines.
+	void reserve(unsigned int n);
+
+	/// Add line given by points A, B and compute its Plucker coordinates.
+	void add(const Point &a, const Point &b);
+
+	/// Number of lines.
+	unsigned int size() const
+	{ return scale_.size(); }
+
+	/// Scale of line @p idx (maximal absolute component of the direction vector).
+	double scale(unsigned int idx) const
+	{ return scale_[idx]; }
+
+	/** @brief Compute products of @p line with all lines of the batch.
+	 * @param line   Plucker coordinates of a line, must be computed.
+	 * @param result Output, resized to @p size().
+	 */
+	void products(const Plucker &line, std::vector<double> &result) const;
+
+private:
+	/// Plucker coordinates, one array per coordinate.
+	std::array<std::vector<double>, 6> coords_;
+	/// Scales of lines.
+	std::vector<double> scale_;
+};
+
 /****************** inline implementation *****************************/
 inline double Plucker::operator[](const unsigned int index) const
 {   ASSERT(computed_);
@@ -16,6 +16,7 @@
  */
 
 
+#include <cmath>
 #include <limits>
 #include <ostream>
 #include "io/element_data_cache.hh"
@@ -38,6 +39,7 @@ template <typename T>
 ElementDataCache<T>::ElementDataCache(std::string field_name, double time, unsigned int row_vec_size, unsigned int boundary_begin)
 : check_scale_data_(CheckScaleData::none)
 {
+	this->set_vtk_type<T>();
 	this->time_ = time;
 	this->field_input_name_ = field_name;
 	this->data_ = create_data_cache(row_vec_size);
@@ -105,6 +107,25 @@ void ElementDataCache<T>::read_binary_data(std::istream &data_stream, unsigned i
 }
 
 
+template <typename T>
+void ElementDataCache<T>::read_double_data(const double *values, unsigned int n_components, unsigned int i_row) {
+	unsigned int idx = i_row * n_components;
+    std::vector<T> &vec = *( data_.get() );
+    for (unsigned int i_col=0; i_col < n_components; ++i_col, ++idx) {
+        ASSERT_LT(idx, vec.size());
+        vec[idx] = static_cast<T>(values[i_col]);
+    }
+}
+
+
+template <typename T>
+char * ElementDataCache<T>::raw_data(std::size_t &n_bytes) {
+    std::vector<T> &vec = *( data_.get() );
+    n_bytes = vec.size() * sizeof(T);
+    return reinterpret_cast<char *>(vec.data());
+}
+
+
 /**
  * Output data element on given index @p idx. Method for writing data
  * to output stream.
@@ -142,20 +163,40 @@ void ElementDataCache<T>::print_ascii_all(ostream &out_stream, unsigned int star
 template <typename T>
 void ElementDataCache<T>::print_binary_all(ostream &out_stream, bool print_data_size, unsigned int start)
 {
+	// double values can be written as Float32, see set_single_precision
+	bool single_precision = std::is_same<T, double>::value && (this->vtk_type_ == VTK_FLOAT32);
+	unsigned int value_size = single_precision ? sizeof(float) : sizeof(T);
 	if (print_data_size) {
 		// write size of data
-		unsigned long long int data_byte_size = this->n_values_ * n_comp_ * sizeof(T);
+		unsigned long long int data_byte_size = this->n_values_ * n_comp_ * value_size;
 		out_stream.write(reinterpret_cast<const char*>(&data_byte_size), sizeof(unsigned long long int));
 	}
     // write data
 	std::vector<T> &vec = *( this->data_.get() );
     for(unsigned int idx = start; idx < this->n_values_; idx++) {
-    	for(unsigned int i = n_comp_*idx; i < n_comp_*(idx+1); ++i )
-    		out_stream.write(reinterpret_cast<const char*>(&(vec[i])), sizeof(T));
+    	for(unsigned int i = n_comp_*idx; i < n_comp_*(idx+1); ++i ) {
+    		if (single_precision) {
+    			float val = static_cast<float>(vec[i]);
+    			out_stream.write(reinterpret_cast<const char*>(&val), sizeof(float));
+    		} else
+    			out_stream.write(reinterpret_cast<const char*>(&(vec[i])), sizeof(T));
+    	}
     }
 }
 
 
+template <typename T>
+void ElementDataCache<T>::quantize(double max_error)
+{
+	if ( !std::is_floating_point<T>::value || (max_error <= 0.0) ) return;
+
+	double step = 2.0 * max_error;
+	std::vector<T> &vec = *( this->data_.get() );
+	for (auto &val : vec)
+		val = static_cast<T>( std::round(val / step) * step );
+}
+
+
 template <typename T>
 void ElementDataCache<T>::print_yaml_subarray(ostream &out_stream, unsigned int precision, unsigned int begin, unsigned int end)
 {
@@ -97,6 +97,12 @@ public:
 	/// Implements @p ElementDataCacheBase::read_binary_data.
 	void read_binary_data(std::istream &data_stream, unsigned int n_components, unsigned int i_row) override;
 
+	/// Implements @p ElementDataCacheBase::read_double_data.
+	void read_double_data(const double *values, unsigned int n_components, unsigned int i_row) override;
+
+	/// Implements @p ElementDataCacheBase::raw_data.
+	char * raw_data(std::size_t &n_bytes) override;
+
     /**
      * Output data element on given index @p idx. Method for writing data
      * to output stream.
@@ -119,6 +125,9 @@ public:
      */
     void print_binary_all(ostream &out_stream, bool print_data_size = true, unsigned int start = 0) override;
 
+    /// Implements @p ElementDataCacheBase::quantize.
+    void quantize(double max_error) override;
+
     void print_yaml_subarray(ostream &out_stream, unsigned int precision, unsigned int begin, unsigned int end) override;
 
     /**
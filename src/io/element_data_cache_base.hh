@@ -78,6 +78,18 @@ public:
 	 */
 	virtual void read_binary_data(std::istream &data_stream, unsigned int n_components, unsigned int i_row)=0;
 
+	/**
+	 * Set data of given \p i_row from values of double type (e.g. binary data of GMSH file), values are converted to type of cache
+	 */
+	virtual void read_double_data(const double *values, unsigned int n_components, unsigned int i_row)=0;
+
+	/**
+	 * Return pointer to the raw storage of cached values and set its size in bytes to \p n_bytes.
+	 *
+	 * Allows to fill whole cache by binary data at once (e.g. by decompressed blocks of VTK appended data).
+	 */
+	virtual char * raw_data(std::size_t &n_bytes)=0;
+
     /**
      * Print one value at given index in ascii format
      */
@@ -93,6 +105,13 @@ public:
      */
     virtual void print_binary_all(ostream &out_stream, bool print_data_size = true, unsigned int start = 0) = 0;
 
+    /**
+     * Round floating point values to the nearest multiple of 2*\p max_error, error of each value is at most \p max_error.
+     *
+     * Lossy quantization improves compression of output data. Integer data are not changed.
+     */
+    virtual void quantize(double max_error) = 0;
+
     /**
      * Print stored values in the YAML format (using JSON like arrays).
      * Used for output of observe values.
@@ -158,6 +177,11 @@ public:
     	return this->vtk_type_;
     }
 
+    /// Write double values as Float32 in binary format (halves size of output), other types are not changed.
+    inline void set_single_precision() {
+    	if (this->vtk_type_ == VTK_FLOAT64) this->vtk_type_ = VTK_FLOAT32;
+    }
+
     /**
      * Get dof_handler_hash_ value.
      */
@@ -324,6 +348,9 @@ public:
         ASSERT_PERMANENT(false).error("Not implemented.");
     }
 
+    void quantize(double) override
+    {}
+
     void print_yaml_subarray(ostream &, unsigned int, unsigned int , unsigned int) override
     {}
 
@@ -336,6 +363,15 @@ public:
     void read_binary_data(std::istream &, unsigned int, unsigned int) override
     {}
 
+    void read_double_data(const double *, unsigned int, unsigned int) override
+    {}
+
+    char * raw_data(std::size_t &n_bytes) override
+    {
+    	n_bytes = 0;
+    	return nullptr;
+    }
+
     std::shared_ptr< ElementDataCacheBase > gather(Distribution *, LongIdx *) override
     {
     	return std::make_shared<DummyElementDataCache>(this->field_input_name_, this->n_comp_);
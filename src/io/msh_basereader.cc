@@ -78,6 +78,11 @@ void BaseMeshReader::read_raw_mesh(Mesh * mesh) {
     read_elements(mesh);
 }
 
+void BaseMeshReader::release_element_data(const std::string &field_name)
+{
+	element_data_values_->erase(field_name);
+}
+
 void BaseMeshReader::set_element_ids(const Mesh &mesh)
 {
 	has_compatible_mesh_ = true;
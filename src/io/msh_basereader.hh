@@ -193,6 +193,13 @@ public:
             MeshDataHeader header, unsigned int expected_n_entities,
             unsigned int expected_n_components, unsigned int boundary_begin);
 
+    /**
+     * Remove data cache of given field from the reader.
+     *
+     * Used by ReaderCache, that holds read data frames itself and limits their total size.
+     */
+    void release_element_data(const std::string &field_name);
+
     /**
      * Set ID vectors from a different mesh.
      * Must be set in order to determine for which IDs the GMSH reader should read the data.
@@ -18,8 +18,13 @@
  */
 
 #include <istream>
+#include <fstream>
+#include <iomanip>
 #include <string>
 #include <limits>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "msh_gmshreader.h"
 #include "io/element_data_cache_base.hh"
@@ -36,19 +41,84 @@
 using namespace std;
 
 
+/// Read one value of given type from binary GMSH file
+template<typename T>
+static T read_binary_item(std::istream &data_stream)
+{
+	T val;
+	data_stream.read(reinterpret_cast<char *>(&val), sizeof(val));
+	return val;
+}
+
+
+/// Get size and time of last modification of file, values are used for check of index file
+static bool get_file_stamp(const std::string &file_name, std::size_t &file_size, long &file_time)
+{
+	struct stat file_stat;
+	if (stat(file_name.c_str(), &file_stat) != 0) return false;
+	file_size = file_stat.st_size;
+	file_time = file_stat.st_mtime;
+	return true;
+}
+
+
+std::size_t GmshMeshReader::index_min_file_size = 10*1024*1024;
+
+
 GmshMeshReader::GmshMeshReader(const FilePath &file_name)
-: BaseMeshReader(file_name)
+: BaseMeshReader(file_name),
+  binary_format_(false),
+  data_size_(sizeof(double)),
+  data_stream_(nullptr)
 {
     tok_.set_comment_pattern( "#");
     data_section_name_ = "$ElementData";
     has_compatible_mesh_ = false;
+    read_mesh_format();
     make_header_table();
 }
 
 
 
 GmshMeshReader::~GmshMeshReader()   // Tokenizer close the file automatically
-{}
+{
+	delete data_stream_;
+}
+
+
+
+void GmshMeshReader::read_mesh_format() {
+    using namespace boost;
+    tok_.set_position( Tokenizer::Position() );
+
+    if (! tok_.skip_to("$MeshFormat", "$Nodes") ) return; // section is optional, ascii format is used
+    try {
+    	tok_.next_line(false);
+    	++tok_; // skip version
+    	binary_format_ = (lexical_cast<unsigned int>(*tok_) == 1); ++tok_;
+    	data_size_ = lexical_cast<unsigned int>(*tok_); ++tok_;
+    } catch (bad_lexical_cast &) {
+    	THROW(ExcWrongFormat() << EI_Type("$MeshFormat") << EI_TokenizerMsg(tok_.position_msg()) << EI_MeshFile(tok_.f_name()) );
+    }
+    if (! binary_format_) return;
+
+    if (data_size_ != sizeof(double))
+    	THROW( ExcUnsupportedBinary() << EI_Position("data size " + std::to_string(data_size_)) << EI_GMSHFile(tok_.f_name()) );
+    data_stream_ = new std::ifstream( tok_.f_name(), std::ios_base::in | std::ios_base::binary );
+    data_stream_->seekg( tok_.get_position().file_position_ );
+    // binary one allows to detect endianness
+    if (read_binary_item<int>(*data_stream_) != 1)
+    	THROW( ExcUnsupportedBinary() << EI_Position("different byte order") << EI_GMSHFile(tok_.f_name()) );
+    skip_binary_data();
+}
+
+
+
+void GmshMeshReader::skip_binary_data() {
+	if (data_stream_->fail())
+		THROW(ExcWrongFormat() << EI_Type("binary data") << EI_TokenizerMsg(tok_.position_msg()) << EI_MeshFile(tok_.f_name()) );
+	tok_.set_position( Tokenizer::Position(data_stream_->tellg(), tok_.line_num(), 0) );
+}
 
 
 
@@ -66,17 +136,29 @@ void GmshMeshReader::read_nodes(Mesh * mesh) {
         if (n_nodes == 0) THROW( ExcZeroNodes() << EI_Position(tok_.position_msg()) );
         ++tok_; // end of line
 
-        for (unsigned int i = 0; i < n_nodes; ++i) {
-        	tok_.next_line();
-
-            unsigned int id = lexical_cast<unsigned int> (*tok_); ++tok_; // node id
-        	arma::vec3 coords;                                         // node coordinates
-        	coords(0) = lexical_cast<double> (*tok_); ++tok_;
-        	coords(1) = lexical_cast<double> (*tok_); ++tok_;
-        	coords(2) = lexical_cast<double> (*tok_); ++tok_;
-            ++tok_; // skip mesh size parameter
-
-            mesh->add_node(id, coords);
+        if (binary_format_) {
+        	// each node is stored as: int id, double x, y, z
+        	data_stream_->seekg( tok_.get_position().file_position_ );
+        	for (unsigned int i = 0; i < n_nodes; ++i) {
+        		unsigned int id = read_binary_item<int>(*data_stream_);
+        		arma::vec3 coords;
+        		data_stream_->read(reinterpret_cast<char *>(coords.memptr()), 3*sizeof(double));
+        		mesh->add_node(id, coords);
+        	}
+        	skip_binary_data();
+        } else {
+            for (unsigned int i = 0; i < n_nodes; ++i) {
+            	tok_.next_line();
+
+                unsigned int id = lexical_cast<unsigned int> (*tok_); ++tok_; // node id
+            	arma::vec3 coords;                                         // node coordinates
+            	coords(0) = lexical_cast<double> (*tok_); ++tok_;
+            	coords(1) = lexical_cast<double> (*tok_); ++tok_;
+            	coords(2) = lexical_cast<double> (*tok_); ++tok_;
+                ++tok_; // skip mesh size parameter
+
+                mesh->add_node(id, coords);
+            }
         }
 
     } catch (bad_lexical_cast &) {
@@ -102,54 +184,58 @@ void GmshMeshReader::read_elements(Mesh * mesh) {
 
         mesh->init_element_vector(n_elements);
 
-        for (unsigned int i = 0; i < n_elements; ++i) {
-        	tok_.next_line();
-            unsigned int id = lexical_cast<unsigned int>(*tok_); ++tok_;
-
-            //get element type: supported:
-            //  1 Line (2 nodes)
-            //  2 Triangle (3 nodes)
-            //  4 Tetrahedron (4 nodes)
-            // 15 Point (1 node)
-            unsigned int type = lexical_cast<unsigned int>(*tok_); ++tok_;
-            unsigned int dim;
-            switch (type) {
-                case 1:
-                    dim = 1;
-                    break;
-                case 2:
-                    dim = 2;
-                    break;
-                case 4:
-                    dim = 3;
-                    break;
-                case 15:
-                    dim = 0;
-                    break;
-                default:
-                    dim = 0;
-                    THROW(ExcUnsupportedType() << EI_ElementId(id) << EI_ElementType(type) << EI_GMSHFile(tok_.f_name()) );
-                    break;
-            }
-
-            //get number of tags (at least 2)
-            unsigned int n_tags = lexical_cast<unsigned int>(*tok_);
-            if (n_tags < 2) THROW( ExcTooManyElementTags() << EI_ElementId(id) << EI_Position(tok_.position_msg()) );
-            ++tok_;
-
-            //get tags 1 and 2
-            unsigned int region_id = lexical_cast<unsigned int>(*tok_); ++tok_; // region_id
-            lexical_cast<unsigned int>(*tok_); ++tok_; // GMSH region number, we do not store this
-            //get remaining tags
-            unsigned int partition_id = 0;
-            if (n_tags > 2)  { partition_id = lexical_cast<unsigned int>(*tok_); ++tok_; } // save partition number from the new GMSH format
-            for (unsigned int ti = 3; ti < n_tags; ti++) ++tok_;         //skip remaining tags
-
-            for (unsigned int ni=0; ni<dim+1; ++ni) { // read node ids
-            	node_ids[ni] = lexical_cast<unsigned int>(*tok_);
+        if (binary_format_) {
+        	read_binary_elements(mesh, n_elements);
+        } else {
+            for (unsigned int i = 0; i < n_elements; ++i) {
+            	tok_.next_line();
+                unsigned int id = lexical_cast<unsigned int>(*tok_); ++tok_;
+
+                //get element type: supported:
+                //  1 Line (2 nodes)
+                //  2 Triangle (3 nodes)
+                //  4 Tetrahedron (4 nodes)
+                // 15 Point (1 node)
+                unsigned int type = lexical_cast<unsigned int>(*tok_); ++tok_;
+                unsigned int dim;
+                switch (type) {
+                    case 1:
+                        dim = 1;
+                        break;
+                    case 2:
+                        dim = 2;
+                        break;
+                    case 4:
+                        dim = 3;
+                        break;
+                    case 15:
+                        dim = 0;
+                        break;
+                    default:
+                        dim = 0;
+                        THROW(ExcUnsupportedType() << EI_ElementId(id) << EI_ElementType(type) << EI_GMSHFile(tok_.f_name()) );
+                        break;
+                }
+
+                //get number of tags (at least 2)
+                unsigned int n_tags = lexical_cast<unsigned int>(*tok_);
+                if (n_tags < 2) THROW( ExcTooManyElementTags() << EI_ElementId(id) << EI_Position(tok_.position_msg()) );
                 ++tok_;
+
+                //get tags 1 and 2
+                unsigned int region_id = lexical_cast<unsigned int>(*tok_); ++tok_; // region_id
+                lexical_cast<unsigned int>(*tok_); ++tok_; // GMSH region number, we do not store this
+                //get remaining tags
+                unsigned int partition_id = 0;
+                if (n_tags > 2)  { partition_id = lexical_cast<unsigned int>(*tok_); ++tok_; } // save partition number from the new GMSH format
+                for (unsigned int ti = 3; ti < n_tags; ti++) ++tok_;         //skip remaining tags
+
+                for (unsigned int ni=0; ni<dim+1; ++ni) { // read node ids
+                	node_ids[ni] = lexical_cast<unsigned int>(*tok_);
+                    ++tok_;
+                }
+                mesh->add_element(id, dim, region_id, partition_id, node_ids);
             }
-            mesh->add_element(id, dim, region_id, partition_id, node_ids);
         }
 
     } catch (bad_lexical_cast &) {
@@ -161,6 +247,43 @@ void GmshMeshReader::read_elements(Mesh * mesh) {
 
 
 
+void GmshMeshReader::read_binary_elements(Mesh * mesh, unsigned int n_elements) {
+	// dimensions of supported GMSH element types: line, triangle, tetrahedron, point
+	static const std::map<int, unsigned int> type_dims = { {1, 1}, {2, 2}, {4, 3}, {15, 0} };
+
+	std::vector<unsigned int> node_ids(4); // maximal count of nodes
+	std::vector<int> elm_data;
+	data_stream_->seekg( tok_.get_position().file_position_ );
+	unsigned int i = 0;
+	while (i < n_elements) {
+		int block_header[3]; // element type, number of elements in block, number of tags
+		data_stream_->read(reinterpret_cast<char *>(block_header), sizeof(block_header));
+		if ( data_stream_->fail() || (block_header[1] <= 0) )
+			THROW(ExcWrongFormat() << EI_Type("binary $Elements") << EI_TokenizerMsg(tok_.position_msg()) << EI_MeshFile(tok_.f_name()) );
+
+		auto dim_it = type_dims.find(block_header[0]);
+		if (dim_it == type_dims.end()) {
+			int id = read_binary_item<int>(*data_stream_);
+			THROW(ExcUnsupportedType() << EI_ElementId(id) << EI_ElementType(block_header[0]) << EI_GMSHFile(tok_.f_name()) );
+		}
+		unsigned int dim = dim_it->second;
+		int n_tags = block_header[2];
+
+		// each element is stored as: id, tags, node ids
+		elm_data.resize(1 + n_tags + dim + 1);
+		for (int i_block = 0; i_block < block_header[1]; ++i_block, ++i) {
+			data_stream_->read(reinterpret_cast<char *>(elm_data.data()), elm_data.size()*sizeof(int));
+			if (n_tags < 2) THROW( ExcTooManyElementTags() << EI_ElementId(elm_data[0]) << EI_Position(tok_.position_msg()) );
+			unsigned int partition_id = (n_tags > 2) ? elm_data[3] : 0;
+			for (unsigned int ni=0; ni<dim+1; ++ni) node_ids[ni] = elm_data[1 + n_tags + ni];
+			mesh->add_element(elm_data[0], dim, elm_data[1], partition_id, node_ids);
+		}
+	}
+	skip_binary_data();
+}
+
+
+
 void GmshMeshReader::read_physical_names(Mesh * mesh) {
 	ASSERT_PTR(mesh).error("Argument mesh is NULL.\n");
 
@@ -263,12 +386,23 @@ void GmshMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDat
     // read @p data buffer as we have correct header with already passed time
     // we assume that @p data buffer is big enough
     tok_.set_position(header.position);
+    std::vector<double> binary_values(header.n_components);
+    if (binary_format_) data_stream_->seekg(header.position.file_position_);
 
     // read data
     for (i_row = 0; i_row < header.n_entities; ++i_row)
         try {
-            tok_.next_line();
-            id = boost::lexical_cast<unsigned int>(*tok_); ++tok_;
+            if (binary_format_) {
+                // each row is stored as: int id, n_components of double values
+                id = read_binary_item<int>(*data_stream_);
+                data_stream_->read(reinterpret_cast<char *>(binary_values.data()), header.n_components*sizeof(double));
+                if (data_stream_->fail())
+                    THROW(ExcWrongFormat() << EI_Type("binary $ElementData") << EI_TokenizerMsg(tok_.position_msg())
+                            << EI_MeshFile(tok_.f_name()) );
+            } else {
+                tok_.next_line();
+                id = boost::lexical_cast<unsigned int>(*tok_); ++tok_;
+            }
 
             while ( std::min(*bulk_id_iter, *bdr_id_iter) < (int)id) { // skip initialization of some rows in data if ID is missing
                 if (*bulk_id_iter < *bdr_id_iter) ++bulk_id_iter;
@@ -277,12 +411,18 @@ void GmshMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDat
 
             if (*bulk_id_iter == (int)id) {
                 // bulk
-                data_cache.read_ascii_data(tok_, header.n_components, (bulk_id_iter - bulk_el_ids.begin()) );
+                if (binary_format_)
+                    data_cache.read_double_data(binary_values.data(), header.n_components, (bulk_id_iter - bulk_el_ids.begin()) );
+                else
+                    data_cache.read_ascii_data(tok_, header.n_components, (bulk_id_iter - bulk_el_ids.begin()) );
                 ++n_bulk_read;  ++bulk_id_iter;
             } else if (*bdr_id_iter == (int)id) {
             	// boundary
                 unsigned int bdr_shift = data_cache.get_boundary_begin();
-                data_cache.read_ascii_data(tok_, header.n_components, (bdr_id_iter - bdr_el_ids.begin() + bdr_shift) );
+                if (binary_format_)
+                    data_cache.read_double_data(binary_values.data(), header.n_components, (bdr_id_iter - bdr_el_ids.begin() + bdr_shift) );
+                else
+                    data_cache.read_ascii_data(tok_, header.n_components, (bdr_id_iter - bdr_el_ids.begin() + bdr_shift) );
                 ++n_bdr_read;  ++bdr_id_iter;
             } else {
                 if ( (*bulk_id_iter != imax) | (*bdr_id_iter != imax) )
@@ -296,7 +436,8 @@ void GmshMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDat
         			<< EI_MeshFile(tok_.f_name()) );
         }
     // possibly skip remaining lines after break
-    while (i_row < header.n_entities) tok_.next_line(false), ++i_row;
+    if (! binary_format_)
+        while (i_row < header.n_entities) tok_.next_line(false), ++i_row;
 
     LogOut().fmt("time: {}; {} bulk and {} boundary entities of field {} read.\n",
     		header.time, n_bulk_read, n_bdr_read, header.field_name);
@@ -307,10 +448,22 @@ void GmshMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDat
 void GmshMeshReader::make_header_table()
 {
 	header_table_.clear();
+	if ( read_header_index() ) {
+		tok_.set_position( Tokenizer::Position() );
+		return;
+	}
+
 	MeshDataHeader header;
+	tok_.set_position( Tokenizer::Position() );
 	while ( !tok_.eof() ) {
         if ( tok_.skip_to("$ElementData") ) {
             read_data_header(header);
+            if (binary_format_) {
+            	// seek behind data block, each row contains int id and n_components of double values
+            	data_stream_->seekg(header.position.file_position_);
+            	data_stream_->seekg(header.n_entities * (sizeof(int) + header.n_components*sizeof(double)), std::ios_base::cur);
+            	skip_binary_data();
+            }
             HeaderTable::iterator it = header_table_.find(header.field_name);
 
             if (it == header_table_.end()) {  // field doesn't exists, insert new vector to map
@@ -326,11 +479,88 @@ void GmshMeshReader::make_header_table()
         }
 	}
 
+	write_header_index();
 	tok_.set_position( Tokenizer::Position() );
 }
 
 
 
+bool GmshMeshReader::read_header_index()
+{
+	std::size_t file_size;
+	long file_time;
+	if ( !get_file_stamp(tok_.f_name(), file_size, file_time) || (file_size < index_min_file_size) ) return false;
+
+	std::ifstream index_file( tok_.f_name() + ".index" );
+	if (! index_file.is_open()) return false;
+
+	// index is valid only for the same size and modification time of mesh file
+	std::string tag;
+	unsigned int version, n_headers;
+	std::size_t index_file_size;
+	long index_file_time;
+	index_file >> tag >> version >> index_file_size >> index_file_time >> n_headers;
+	if ( index_file.fail() || (tag != "$GmshDataIndex") || (version != 1)
+			|| (index_file_size != file_size) || (index_file_time != file_time) ) return false;
+
+	HeaderTable header_table;
+	for (unsigned int i=0; i<n_headers; ++i) {
+		MeshDataHeader header;
+		std::streamoff file_position;
+		index_file >> header.time >> header.time_index >> header.n_components >> header.n_entities >> header.partition_index
+				>> file_position >> header.position.line_counter_ >> header.position.line_position_;
+		index_file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		std::getline(index_file, header.field_name);
+		std::getline(index_file, header.interpolation_scheme);
+		if (index_file.fail()) return false;
+		header.position.file_position_ = file_position;
+		header.discretization = OutputTime::DiscreteSpace::ELEM_DATA;
+		header_table[header.field_name].push_back(header); // headers are stored sorted by time
+	}
+
+	header_table_.swap(header_table);
+	return true;
+}
+
+
+
+void GmshMeshReader::write_header_index()
+{
+	std::size_t file_size;
+	long file_time;
+	if ( header_table_.empty() || !get_file_stamp(tok_.f_name(), file_size, file_time) || (file_size < index_min_file_size) ) return;
+
+	unsigned int n_headers = 0;
+	for (auto &table_item : header_table_) n_headers += table_item.second.size();
+
+	// write to temporary file and rename it, more processes can create index of the same file
+	char host_name[256] = "";
+	gethostname(host_name, sizeof(host_name)-1);
+	std::string index_name = tok_.f_name() + ".index";
+	std::string tmp_name = index_name + "." + host_name + "." + std::to_string(getpid());
+	{
+		std::ofstream index_file(tmp_name);
+		if (! index_file.is_open()) return; // directory of mesh file is not writable, index is not created
+		index_file << std::setprecision(17);
+		index_file << "$GmshDataIndex 1 " << file_size << " " << file_time << " " << n_headers << "\n";
+		for (auto &table_item : header_table_)
+			for (auto &header : table_item.second) {
+				index_file << header.time << " " << header.time_index << " " << header.n_components << " " << header.n_entities
+						<< " " << header.partition_index << " " << (std::streamoff)header.position.file_position_
+						<< " " << header.position.line_counter_ << " " << header.position.line_position_ << "\n";
+				index_file << header.field_name << "\n" << header.interpolation_scheme << "\n";
+			}
+		if (index_file.fail()) {
+			index_file.close();
+			std::remove(tmp_name.c_str());
+			return;
+		}
+	}
+	if (std::rename(tmp_name.c_str(), index_name.c_str()) != 0) std::remove(tmp_name.c_str());
+}
+
+
+
 BaseMeshReader::MeshDataHeader & GmshMeshReader::find_header(BaseMeshReader::HeaderQuery &header_query)
 {
 	// check discretization, only type element_data or undefined is supported
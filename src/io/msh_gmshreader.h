@@ -50,6 +50,15 @@ public:
 			<< "Zero number of elements, " << EI_Position::val << ".\n");
 	DECLARE_EXCEPTION(ExcTooManyElementTags,
 			<< "At least two element tags have to be defined for element with id=" << EI_ElementId::val << ", " << EI_Position::val << ".\n");
+	DECLARE_EXCEPTION(ExcUnsupportedBinary,
+			<< "Unsupported binary format, " << EI_Position::val << ", in the GMSH input file: " << EI_GMSHFile::qval << ".\n");
+
+	/**
+	 * Minimal size of mesh file (in bytes) for which the table of ElementData headers is stored to the index file.
+	 *
+	 * Scanning of small files is fast, index file is not created for them.
+	 */
+	static std::size_t index_min_file_size;
 
     /**
      * Construct the GMSH format reader from given FilePath.
@@ -97,14 +106,40 @@ protected:
      * assign regions to the boundary and are not used in actual FEM computations.
      */
     void read_elements(Mesh * mesh);
+    /**
+     * Reads \p n_elements of binary '$Elements' section, called from \p read_elements.
+     *
+     * Elements are stored in blocks of the same type, each block starts with: element type, number of elements, number of tags.
+     */
+    void read_binary_elements(Mesh * mesh, unsigned int n_elements);
     /**
      * Reads the header from the tokenizer @p tok and return it as the second parameter.
      */
     void read_data_header(MeshDataHeader &head);
     /**
-     * Reads table of ElementData headers from the tokenizer file.
+     * Reads table of ElementData headers from the index file or from the tokenizer file.
+     *
+     * If the table is read from the mesh file, it is stored to the index file for next runs.
      */
     void make_header_table() override;
+    /**
+     * Reads section '$MeshFormat' and sets format of file (ascii or binary).
+     */
+    void read_mesh_format();
+    /**
+     * Reads table of ElementData headers from the index file.
+     *
+     * Returns false if index file doesn't exist or doesn't correspond to the mesh file.
+     */
+    bool read_header_index();
+    /**
+     * Writes table of ElementData headers to the index file stored next to the mesh file.
+     */
+    void write_header_index();
+    /**
+     * Set position of tokenizer behind the binary data ends at actual position of \p data_stream_.
+     */
+    void skip_binary_data();
     /**
      * Implements @p BaseMeshReader::read_element_data.
      */
@@ -113,6 +148,15 @@ protected:
 
     /// Table with data of ElementData headers
     HeaderTable header_table_;
+
+    /// Flag marks binary GMSH file
+    bool binary_format_;
+
+    /// Size of floating point values in binary file
+    unsigned int data_size_;
+
+    /// Input stream allows read binary data, used only for binary files
+    std::istream *data_stream_;
 };
 
 #endif	/* _GMSHMESHREADER_H */
@@ -19,7 +19,13 @@
 
 #include <iostream>
 #include <vector>
+#include <thread>
+#include <cstring>
 #include <pugixml.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "boost/lexical_cast.hpp"
 
 #include "msh_vtkreader.hh"
@@ -58,6 +64,26 @@ uint64_t read_header_type(DataType data_header_type, std::istream &data_stream)
 }
 
 
+/// Read value of header type from memory mapped data and move \p data behind this value.
+uint64_t read_header_type(DataType data_header_type, const char * &data)
+{
+	if (data_header_type == DataType::uint64) {
+		uint64_t val;
+		std::memcpy(&val, data, sizeof(val));
+		data += sizeof(val);
+		return val;
+	} else if (data_header_type == DataType::uint32) {
+		uint32_t val;
+		std::memcpy(&val, data, sizeof(val));
+		data += sizeof(val);
+		return (uint64_t)val;
+	} else {
+		ASSERT_PERMANENT(false).error("Unsupported header_type!\n"); //should not happen
+		return 0;
+	}
+}
+
+
 /*******************************************************************
  * implementation of VtkMeshReader
  */
@@ -66,6 +92,8 @@ const double VtkMeshReader::point_tolerance = 1E-10;
 
 VtkMeshReader::VtkMeshReader(const FilePath &file_name)
 : BaseMeshReader(file_name),
+  mapped_file_(nullptr),
+  mapped_size_(0),
   time_step_(0.0)
 {
     data_section_name_ = "DataArray";
@@ -77,6 +105,8 @@ VtkMeshReader::VtkMeshReader(const FilePath &file_name)
 
 VtkMeshReader::VtkMeshReader(const FilePath &file_name, std::shared_ptr<ElementDataFieldMap> element_data_values, double time_step)
 : BaseMeshReader(file_name, element_data_values),
+  mapped_file_(nullptr),
+  mapped_size_(0),
   time_step_(time_step)
 {
 	data_section_name_ = "DataArray";
@@ -89,6 +119,7 @@ VtkMeshReader::VtkMeshReader(const FilePath &file_name, std::shared_ptr<ElementD
 VtkMeshReader::~VtkMeshReader()
 {
 	delete data_stream_;
+	if (mapped_file_ != nullptr) munmap( const_cast<char *>(mapped_file_), mapped_size_ );
 }
 
 
@@ -154,6 +185,33 @@ Tokenizer::Position VtkMeshReader::get_appended_position() {
 }
 
 
+void VtkMeshReader::map_file()
+{
+	if (mapped_file_ != nullptr) return; // file is mapped only once
+
+	int fd = open(tok_.f_name().c_str(), O_RDONLY);
+	if (fd < 0) return;
+	struct stat file_stat;
+	if ( (fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0) ) {
+		void *addr = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED) {
+			mapped_file_ = static_cast<const char *>(addr);
+			mapped_size_ = file_stat.st_size;
+		}
+	}
+	close(fd); // mapping remains valid after closing of the file descriptor
+}
+
+
+const char * VtkMeshReader::mapped_data(std::size_t pos, std::size_t n_bytes)
+{
+	if ( (pos > mapped_size_) || (n_bytes > mapped_size_ - pos) )
+		THROW(ExcWrongFormat() << EI_Type("AppendedData section") << EI_TokenizerMsg("unexpected end of file")
+				<< EI_MeshFile(tok_.f_name()) );
+	return mapped_file_ + pos;
+}
+
+
 BaseMeshReader::MeshDataHeader VtkMeshReader::create_header(pugi::xml_node node, unsigned int n_entities, Tokenizer::Position pos,
 		OutputTime::DiscreteSpace disc)
 {
@@ -217,6 +275,7 @@ void VtkMeshReader::make_header_table()
 		// no AppendedData tag
 	} else {
 		appended_pos = get_appended_position();
+		map_file();
 	}
 
 	pugi::xml_node node = doc.child("VTKFile").child("UnstructuredGrid").child("Piece");
@@ -336,19 +395,41 @@ unsigned int VtkMeshReader::type_value_size(DataType data_type)
 
 void VtkMeshReader::read_element_data(ElementDataCacheBase &data_cache, MeshDataHeader header) {
 
+	// binary data are copied to the cache, type of values in the file must be the same as type of the cache,
+	// only Float32 values (written with 'single_precision' key of VTK output) are converted to double
+	if ( (data_format_ != DataFormat::ascii) && (header.type != DataType::undefined)
+			&& !is_cache_type(header.type, data_cache.vtk_type()) ) {
+		if ( (header.type == DataType::float32) && (data_cache.vtk_type() == ElementDataCacheBase::VTK_FLOAT64) ) {
+			parse_float32_data( data_cache, header.n_entities, header.position );
+			LogOut().fmt("time: {}; {} entities of field {} read.\n",
+					header.time, n_read_, header.field_name);
+			return;
+		}
+		THROW( ExcWrongType() << EI_ErrMessage("Unsupported") << EI_SectionTypeName("DataArray " + header.field_name)
+				<< EI_VTKFile(tok_.f_name()) );
+	}
+
     switch (data_format_) {
 		case DataFormat::ascii: {
 			parse_ascii_data( data_cache, header.n_components, header.n_entities, header.position );
 			break;
 		}
 		case DataFormat::binary_uncompressed: {
-			ASSERT_PTR(data_stream_).error();
-			parse_binary_data( data_cache, header.n_components, header.n_entities, header.position);
+			if (mapped_file_ != nullptr) {
+				parse_mapped_binary_data( data_cache, header.n_components, header.n_entities, header.position);
+			} else {
+				ASSERT_PTR(data_stream_).error();
+				parse_binary_data( data_cache, header.n_components, header.n_entities, header.position);
+			}
 			break;
 		}
 		case DataFormat::binary_zlib: {
-			ASSERT_PTR(data_stream_).error();
-			parse_compressed_data( data_cache, header.n_components, header.n_entities, header.position);
+			if (mapped_file_ != nullptr) {
+				parse_mapped_compressed_data( data_cache, header.n_components, header.n_entities, header.position);
+			} else {
+				ASSERT_PTR(data_stream_).error();
+				parse_compressed_data( data_cache, header.n_components, header.n_entities, header.position);
+			}
 			break;
 		}
 		default: {
@@ -398,6 +479,20 @@ void VtkMeshReader::parse_binary_data(ElementDataCacheBase &data_cache, unsigned
 
 void VtkMeshReader::parse_compressed_data(ElementDataCacheBase &data_cache, unsigned int n_components, unsigned int n_entities,
 		Tokenizer::Position pos)
+{
+	stringstream decompressed_data;
+	inflate_stream_data(pos, decompressed_data);
+
+    n_read_ = 0;
+
+	for (unsigned int i_row = 0; i_row < n_entities; ++i_row) {
+		data_cache.read_binary_data(decompressed_data, n_components, i_row);
+        n_read_++;
+	}
+}
+
+
+uint64_t VtkMeshReader::inflate_stream_data(Tokenizer::Position pos, std::stringstream &decompressed_data)
 {
 	data_stream_->seekg(pos.file_position_);
 	uint64_t n_blocks = read_header_type(header_type_, *data_stream_);
@@ -410,7 +505,6 @@ void VtkMeshReader::parse_compressed_data(ElementDataCacheBase &data_cache, unsi
 		block_sizes.push_back( read_header_type(header_type_, *data_stream_) );
 	}
 
-	stringstream decompressed_data;
 	uint64_t decompressed_data_size = 0;
 	for (uint64_t i = 0; i < n_blocks; ++i) {
 		uint64_t decompressed_block_size = (i==n_blocks-1 && p_size>0) ? p_size : u_size;
@@ -440,12 +534,152 @@ void VtkMeshReader::parse_compressed_data(ElementDataCacheBase &data_cache, unsi
 		decompressed_data_size += decompressed_block_size;
 	}
 
-    n_read_ = 0;
+	return decompressed_data_size;
+}
 
-	for (unsigned int i_row = 0; i_row < n_entities; ++i_row) {
-		data_cache.read_binary_data(decompressed_data, n_components, i_row);
-        n_read_++;
+
+void VtkMeshReader::parse_mapped_binary_data(ElementDataCacheBase &data_cache, unsigned int, unsigned int n_entities,
+		Tokenizer::Position pos)
+{
+	std::size_t cache_size;
+	char *cache_data = data_cache.raw_data(cache_size);
+	uint64_t data_size = copy_mapped_data(pos.file_position_, cache_data, cache_size);
+	std::size_t copy_size = std::min(cache_size, (std::size_t)data_size);
+
+	n_read_ = (data_size > 0) ? std::min( (uint64_t)n_entities, (uint64_t)copy_size * n_entities / data_size ) : 0;
+}
+
+
+uint64_t VtkMeshReader::copy_mapped_data(std::size_t file_pos, char *target, std::size_t target_size)
+{
+	std::size_t header_size = type_value_size(header_type_);
+	const char *data = mapped_data(file_pos, header_size);
+	uint64_t data_size = read_header_type(header_type_, data);
+	data = mapped_data(file_pos + header_size, data_size);
+
+	std::memcpy(target, data, std::min(target_size, (std::size_t)data_size));
+	return data_size;
+}
+
+
+void VtkMeshReader::parse_mapped_compressed_data(ElementDataCacheBase &data_cache, unsigned int, unsigned int n_entities,
+		Tokenizer::Position pos)
+{
+	std::size_t cache_size;
+	char *cache_data = data_cache.raw_data(cache_size);
+	uint64_t data_size = inflate_mapped_data(pos.file_position_, cache_data, cache_size);
+	std::size_t copy_size = std::min(cache_size, (std::size_t)data_size);
+
+	n_read_ = (data_size > 0) ? std::min( (uint64_t)n_entities, (uint64_t)copy_size * n_entities / data_size ) : 0;
+}
+
+
+uint64_t VtkMeshReader::inflate_mapped_data(std::size_t file_pos, char *target, std::size_t target_size)
+{
+	std::size_t header_size = type_value_size(header_type_);
+	const char *data = mapped_data(file_pos, 3*header_size);
+	uint64_t n_blocks = read_header_type(header_type_, data);
+	uint64_t u_size = read_header_type(header_type_, data);
+	uint64_t p_size = read_header_type(header_type_, data);
+
+	// offsets of compressed blocks in mapped file
+	data = mapped_data(file_pos + 3*header_size, n_blocks*header_size);
+	std::vector<uint64_t> block_sizes(n_blocks);
+	std::vector<uint64_t> block_offsets(n_blocks+1);
+	block_offsets[0] = file_pos + (3+n_blocks)*header_size;
+	for (uint64_t i = 0; i < n_blocks; ++i) {
+		block_sizes[i] = read_header_type(header_type_, data);
+		block_offsets[i+1] = block_offsets[i] + block_sizes[i];
+	}
+	const char *compressed_data = mapped_data(block_offsets[0], block_offsets[n_blocks] - block_offsets[0]);
+	uint64_t data_size = (n_blocks > 0) ? (n_blocks-1)*u_size + ( (p_size>0) ? p_size : u_size ) : 0;
+
+	// blocks are decompressed directly to the target if it is large enough, otherwise (inconsistent header) through buffer
+	std::vector<char> buffer;
+	char *inflate_target = target;
+	if (data_size > target_size) {
+		buffer.resize(data_size);
+		inflate_target = buffer.data();
 	}
+
+	// every thread decompresses each n_threads-th block, blocks are independent zlib streams
+	unsigned int n_threads = n_local_threads( (unsigned int)n_blocks );
+	std::vector<int> block_status(n_blocks, Z_OK);
+	auto inflate_blocks = [&](unsigned int i_thread) {
+		for (uint64_t i = i_thread; i < n_blocks; i += n_threads) {
+			uLongf decompressed_block_size = (i==n_blocks-1 && p_size>0) ? p_size : u_size;
+			uLongf expected_size = decompressed_block_size;
+			block_status[i] = uncompress( (Bytef *)(inflate_target + i*u_size), &decompressed_block_size,
+					(const Bytef *)(compressed_data + (block_offsets[i] - block_offsets[0])), block_sizes[i] );
+			if ( (block_status[i] == Z_OK) && (decompressed_block_size != expected_size) ) block_status[i] = Z_DATA_ERROR;
+		}
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int i_thread = 1; i_thread < n_threads; ++i_thread)
+		threads.push_back( std::thread(inflate_blocks, i_thread) );
+	inflate_blocks(0);
+	for (auto &thread : threads) thread.join();
+
+	for (uint64_t i = 0; i < n_blocks; ++i)
+		if (block_status[i] != Z_OK)
+			THROW(ExcWrongFormat() << EI_Type("compressed AppendedData section")
+					<< EI_TokenizerMsg("zlib error " + std::to_string(block_status[i]) + " in block " + std::to_string(i))
+					<< EI_MeshFile(tok_.f_name()) );
+
+	if (inflate_target != target) std::memcpy(target, inflate_target, std::min(target_size, (std::size_t)data_size));
+	return data_size;
+}
+
+
+uint64_t VtkMeshReader::read_raw_data(Tokenizer::Position pos, char *target, std::size_t target_size)
+{
+	if (mapped_file_ != nullptr) {
+		if (data_format_ == DataFormat::binary_zlib) return inflate_mapped_data(pos.file_position_, target, target_size);
+		else return copy_mapped_data(pos.file_position_, target, target_size);
+	}
+
+	ASSERT_PTR(data_stream_).error();
+	if (data_format_ == DataFormat::binary_zlib) {
+		stringstream decompressed_data;
+		uint64_t data_size = inflate_stream_data(pos, decompressed_data);
+		decompressed_data.read(target, std::min(target_size, (std::size_t)data_size));
+		return data_size;
+	}
+	data_stream_->seekg(pos.file_position_);
+	uint64_t data_size = read_header_type(header_type_, *data_stream_);
+	data_stream_->read(target, std::min(target_size, (std::size_t)data_size));
+	return data_size;
+}
+
+
+void VtkMeshReader::parse_float32_data(ElementDataCacheBase &data_cache, unsigned int n_entities, Tokenizer::Position pos)
+{
+	// values are read to the buffer and converted to double values of the cache
+	std::size_t cache_size;
+	double *cache_data = reinterpret_cast<double *>( data_cache.raw_data(cache_size) );
+	std::size_t n_values = cache_size / sizeof(double);
+	std::vector<float> buffer(n_values);
+	uint64_t data_size = read_raw_data(pos, reinterpret_cast<char *>(buffer.data()), n_values*sizeof(float));
+
+	std::size_t n_copied = std::min( n_values, (std::size_t)(data_size / sizeof(float)) );
+	for (std::size_t i = 0; i < n_copied; ++i) cache_data[i] = buffer[i];
+
+	n_read_ = (data_size > 0) ? std::min( (uint64_t)n_entities, (uint64_t)n_copied * sizeof(float) * n_entities / data_size ) : 0;
+}
+
+
+bool VtkMeshReader::is_cache_type(DataType data_type, ElementDataCacheBase::VTKValueType cache_type)
+{
+	// VTK types of DataType values, 64-bit integers are not supported by data caches
+	static const std::vector<int> vtk_types = {
+			ElementDataCacheBase::VTK_INT8, ElementDataCacheBase::VTK_UINT8, ElementDataCacheBase::VTK_INT16,
+			ElementDataCacheBase::VTK_UINT16, ElementDataCacheBase::VTK_INT32, ElementDataCacheBase::VTK_UINT32,
+			-1, -1, ElementDataCacheBase::VTK_FLOAT32, ElementDataCacheBase::VTK_FLOAT64, -1 };
+
+	// signed and unsigned 32-bit integers (e.g. offsets and connectivity) are stored in the same way
+	if ( (data_type == DataType::int32) || (data_type == DataType::uint32) )
+		return (cache_type == ElementDataCacheBase::VTK_INT32) || (cache_type == ElementDataCacheBase::VTK_UINT32);
+	return vtk_types[data_type] == cache_type;
 }
 
 
@@ -22,6 +22,7 @@
 
 #include <istream>                           // for istream
 #include <map>                               // for map, map<>::value_compare
+#include <sstream>                           // for stringstream
 #include <string>                            // for string
 #include <armadillo>
 #include "io/msh_basereader.hh"              // for MeshDataHeader, DataType
@@ -149,12 +150,52 @@ protected:
 	void parse_compressed_data(ElementDataCacheBase &data_cache, unsigned int n_components, unsigned int n_entities,
 			Tokenizer::Position pos);
 
+	/// Uncompress blocks of mapped compressed data directly to data cache, blocks are processed in parallel threads
+	void parse_mapped_compressed_data(ElementDataCacheBase &data_cache, unsigned int n_components, unsigned int n_entities,
+			Tokenizer::Position pos);
+
+	/// Copy mapped binary data to data cache
+	void parse_mapped_binary_data(ElementDataCacheBase &data_cache, unsigned int n_components, unsigned int n_entities,
+			Tokenizer::Position pos);
+
+	/// Read Float32 binary data (written with single precision) and convert them to double values of data cache
+	void parse_float32_data(ElementDataCacheBase &data_cache, unsigned int n_entities, Tokenizer::Position pos);
+
+	/// Uncompress compressed data from \p data_stream_ to \p decompressed_data, return size of uncompressed data
+	uint64_t inflate_stream_data(Tokenizer::Position pos, std::stringstream &decompressed_data);
+
+	/**
+	 * Uncompress blocks of mapped compressed data to \p target, blocks are processed in parallel threads.
+	 *
+	 * At most \p target_size bytes are stored, returns size of uncompressed data given by header.
+	 */
+	uint64_t inflate_mapped_data(std::size_t file_pos, char *target, std::size_t target_size);
+
+	/// Copy at most \p target_size bytes of mapped binary data to \p target, return size of data given by header
+	uint64_t copy_mapped_data(std::size_t file_pos, char *target, std::size_t target_size);
+
+	/// Read at most \p target_size bytes of binary (possibly compressed) data to \p target, return size of data
+	uint64_t read_raw_data(Tokenizer::Position pos, char *target, std::size_t target_size);
+
+	/// Check if values of \p data_type can be copied to data cache of \p cache_type without conversion
+	bool is_cache_type(DataType data_type, ElementDataCacheBase::VTKValueType cache_type);
+
 	/// Set base attributes of VTK and get count of nodes and elements.
 	void read_base_vtk_attributes(pugi::xml_node vtk_node, unsigned int &n_nodes, unsigned int &n_elements);
 
 	/// Get position of AppendedData tag in VTK file
 	Tokenizer::Position get_appended_position();
 
+	/**
+	 * Map VTK file to memory. Called once if file contains AppendedData tag.
+	 *
+	 * If mapping fails, binary data are read through \p data_stream_.
+	 */
+	void map_file();
+
+	/// Check that mapped file contains \p n_bytes from position \p pos, return pointer to this position.
+	const char * mapped_data(std::size_t pos, std::size_t n_bytes);
+
     /**
      * Implements @p BaseMeshReader::read_element_data.
      */
@@ -175,6 +216,12 @@ protected:
     /// input stream allow read appended data, used only if this tag exists
     std::istream *data_stream_;
 
+    /// memory mapped VTK file, used only if AppendedData tag exists (nullptr otherwise)
+    const char *mapped_file_;
+
+    /// size of \p mapped_file_ in bytes
+    std::size_t mapped_size_;
+
     /// store count of read entities
     unsigned int n_read_;
 
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <unordered_set>
 #include <queue>
+#include <mpi.h>
 
 #include "system/global_defs.h"
 #include "input/accessors.hh"
@@ -25,6 +26,7 @@
 #include "io/element_data_cache.hh"
 #include "fem/mapping_p1.hh"
 #include "tools/time_governor.hh"
+#include "system/sys_profiler.hh"
 
 
 namespace IT = Input::Type;
@@ -195,21 +197,30 @@ void ObservePoint::snap(Mesh &mesh)
 
 
 
+arma::vec3 ObservePoint::bih_search_point(Mesh &mesh) const {
+    return mesh.get_bih_tree().tree_box().project_point(input_point_);
+}
+
+
+
 void ObservePoint::find_observe_point(Mesh &mesh) {
+    // search for the initial element
+    vector<unsigned int> candidate_list;
+    mesh.get_bih_tree().find_point(bih_search_point(mesh), candidate_list, true);
+    find_observe_point(mesh, candidate_list);
+}
+
+
+
+void ObservePoint::find_observe_point(Mesh &mesh, const std::vector<unsigned int> &candidate_list) {
     RegionSet region_set = mesh.region_db().get_region_set(snap_region_name_);
     if (region_set.size() == 0)
         THROW( RegionDB::ExcUnknownSet() << RegionDB::EI_Label(snap_region_name_) << in_rec_.ei_address() );
 
 
-    const BIHTree &bih_tree=mesh.get_bih_tree();
-    vector<unsigned int> candidate_list;
     std::unordered_set<unsigned int> closed_elements(1023);
     std::priority_queue< ObservePointData, std::vector<ObservePointData>, CompareByDist > candidate_queue;
 
-    // search for the initial element
-    auto projected_point = bih_tree.tree_box().project_point(input_point_);
-    bih_tree.find_point(projected_point, candidate_list, true);
-
     // closest element
     ObservePointData min_observe_point_data;
     
@@ -279,6 +290,11 @@ void ObservePoint::find_observe_point(Mesh &mesh) {
             << EI_ClosestEle(min_observe_point_data));
     }
     snap( mesh );
+}
+
+
+
+void ObservePoint::check_distance(Mesh &mesh) {
     ElementAccessor<3> elm = mesh.element_accessor(observe_data_.element_idx_);
     double dist = arma::norm(elm.centre() - input_point_, 2);
     double elm_norm = arma::norm(elm.bounding_box().max() - elm.bounding_box().min(), 2);
@@ -351,9 +367,11 @@ Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array,
     unsigned int global_point_idx=0, local_point_idx=0;
 
     // in_rec is Output input record.
-    for(auto it = in_array.begin<Input::Record>(); it != in_array.end(); ++it) {
-        ObservePoint point(*it, mesh, points_.size());
-        point.find_observe_point(mesh);
+    for(auto it = in_array.begin<Input::Record>(); it != in_array.end(); ++it)
+        points_.push_back( ObservePoint(*it, mesh, points_.size()) );
+    find_observe_points(mesh);
+
+    for(auto &point : points_) {
         point.observe_data_.global_idx_ = global_point_idx++;
         if (point.observe_data_.proc_ == mesh.get_el_ds()->myp()) {
         	point.observe_data_.local_idx_ = local_point_idx++;
@@ -361,11 +379,13 @@ Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array,
         }
         else
         	point.observe_data_.local_idx_ = -1;
-        points_.push_back( point );
         observed_element_indices_.push_back(point.observe_data_.element_idx_);
     }
     // make local to global map, distribution
     point_ds_ = new Distribution(Observe::max_observe_value_time * point_4_loc_.size(), PETSC_COMM_WORLD);
+    local_to_global_.resize(Observe::max_observe_value_time*point_4_loc_.size());
+	for (unsigned int i=0; i<Observe::max_observe_value_time; ++i)
+		for (unsigned int j=0; j<point_4_loc_.size(); ++j) local_to_global_[i*point_4_loc_.size()+j] = i*points_.size()+point_4_loc_[j];
 
     // make indices unique
     std::sort(observed_element_indices_.begin(), observed_element_indices_.end());
@@ -393,6 +413,14 @@ Observe::Observe(string observe_name, Mesh &mesh, Input::Array in_array,
 
 Observe::~Observe() {
     flush_values();
+    if (write_future_.valid()) {
+        // exception of the asynchronous write can not be propagated from destructor
+        try {
+            write_future_.get();
+        } catch (std::exception &e) {
+            WarningOut() << "Writing of observe values to file '" << observe_name_ << "_observe.yaml' failed:\n" << e.what() << "\n";
+        }
+    }
     observe_file_.close();
     if (point_ds_!=nullptr) delete point_ds_;
 }
@@ -429,29 +457,81 @@ void Observe::output_header() {
 
 }
 
+void Observe::find_observe_points(Mesh &mesh) {
+    START_TIMER("Observe::find_observe_points");
+    // packed result of one point: element, distance, process, dimension, local coords (3), global coords (3)
+    const unsigned int n_packed = 10;
+    Distribution search_ds(DistributionBlock(), points_.size(), MPI_COMM_WORLD);
+
+    // initial candidates of all local points are found by one pass through the BIH tree
+    std::vector<arma::vec3> search_points;
+    for (unsigned int i_point=search_ds.begin(); i_point<search_ds.end(); ++i_point)
+        search_points.push_back( points_[i_point].bih_search_point(mesh) );
+    std::vector< std::vector<unsigned int> > candidate_lists;
+    mesh.get_bih_tree().find_points(search_points, candidate_lists, true);
+
+    std::vector<double> local_results(n_packed * search_ds.lsize(), -1.0);
+    for (unsigned int i_point=search_ds.begin(); i_point<search_ds.end(); ++i_point) {
+        ObservePoint &point = points_[i_point];
+        double *result = &local_results[ n_packed * (i_point - search_ds.begin()) ];
+        try {
+            point.find_observe_point(mesh, candidate_lists[i_point - search_ds.begin()]);
+        } catch (ExceptionBase &) {
+            // searched again on all processes below
+            continue;
+        }
+        const ObservePointData &data = point.observe_data_;
+        result[0] = data.element_idx_;
+        result[1] = data.distance_;
+        result[2] = data.proc_;
+        result[3] = data.local_coords_.n_elem;
+        for (unsigned int i=0; i<data.local_coords_.n_elem; ++i) result[4+i] = data.local_coords_(i);
+        for (unsigned int i=0; i<3; ++i) result[7+i] = data.global_coords_(i);
+    }
+
+    std::vector<int> rec_counts(search_ds.np()), rec_starts(search_ds.np());
+    for (unsigned int i_proc=0; i_proc<search_ds.np(); ++i_proc) {
+        rec_counts[i_proc] = n_packed * search_ds.lsize(i_proc);
+        rec_starts[i_proc] = n_packed * search_ds.begin(i_proc);
+    }
+    std::vector<double> results(n_packed * points_.size());
+    MPI_Allgatherv(local_results.data(), local_results.size(), MPI_DOUBLE,
+            results.data(), rec_counts.data(), rec_starts.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+
+    for (unsigned int i_point=0; i_point<points_.size(); ++i_point) {
+        const double *result = &results[ n_packed * i_point ];
+        if (result[0] < 0) {
+            // throws the exception of the failed search
+            points_[i_point].find_observe_point(mesh);
+            continue;
+        }
+        ObservePointData &data = points_[i_point].observe_data_;
+        data.element_idx_ = (unsigned int)result[0];
+        data.distance_ = result[1];
+        data.proc_ = (unsigned int)result[2];
+        data.local_coords_.set_size( (unsigned int)result[3] );
+        for (unsigned int i=0; i<data.local_coords_.n_elem; ++i) data.local_coords_(i) = result[4+i];
+        for (unsigned int i=0; i<3; ++i) data.global_coords_(i) = result[7+i];
+        // warning is printed on process #0, point can be found on other process
+        points_[i_point].check_distance(mesh);
+    }
+    END_TIMER("Observe::find_observe_points");
+}
+
 void Observe::flush_values() {
     if (points_.size() == 0 || observe_field_values_.size() == 0) return;
 
-	std::vector<LongIdx> local_to_global(Observe::max_observe_value_time*point_4_loc_.size());
-	for (unsigned int i=0; i<Observe::max_observe_value_time; ++i)
-		for (unsigned int j=0; j<point_4_loc_.size(); ++j) local_to_global[i*point_4_loc_.size()+j] = i*points_.size()+point_4_loc_[j];
-
+    std::vector<OutputDataPtr> serial_data;
 	for(auto &field_data : observe_field_values_) {
-		auto serial_data = field_data.second->gather(point_ds_, &(local_to_global[0]));
-		if (rank_==0) field_data.second = serial_data;
+		auto field_serial_data = field_data.second->gather(point_ds_, local_to_global_.data());
+		if (rank_==0) serial_data.push_back(field_serial_data);
 	}
 
 	if (rank_ == 0) {
-		unsigned int indent = 2;
-		DebugOut() << "Observe::output_time_frame WRITE\n";
-		for (unsigned int i_time=0; i_time<observe_time_idx_; ++i_time) {
-			observe_file_ << setw(indent) << "" << "- time: " << observe_values_time_[i_time] << endl;
-			for(auto &field_data : observe_field_values_) {
-				observe_file_ << setw(indent) << "" << "  " << field_data.second->field_input_name() << ": ";
-				field_data.second->print_yaml_subarray(observe_file_, precision_, i_time*points_.size(), (i_time+1)*points_.size());
-				observe_file_ << endl;
-			}
-		}
+		// the previous write must be finished, it uses the same stream
+		if (write_future_.valid()) write_future_.get();
+		std::vector<double> times(observe_values_time_.begin(), observe_values_time_.begin() + observe_time_idx_);
+		write_future_ = std::async(std::launch::async, &Observe::write_values, this, std::move(times), std::move(serial_data));
 	}
 
     observe_values_time_.clear();
@@ -460,6 +540,18 @@ void Observe::flush_values() {
     observe_time_idx_ = 0;
 }
 
+void Observe::write_values(std::vector<double> times, std::vector<OutputDataPtr> serial_data) {
+	unsigned int indent = 2;
+	for (unsigned int i_time=0; i_time<times.size(); ++i_time) {
+		observe_file_ << setw(indent) << "" << "- time: " << times[i_time] << endl;
+		for(auto &field_data : serial_data) {
+			observe_file_ << setw(indent) << "" << "  " << field_data->field_input_name() << ": ";
+			field_data->print_yaml_subarray(observe_file_, precision_, i_time*points_.size(), (i_time+1)*points_.size());
+			observe_file_ << endl;
+		}
+	}
+}
+
 void Observe::output_time_frame(bool flush) {
     if ( ! no_fields_warning ) {
         no_fields_warning=true;
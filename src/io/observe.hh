@@ -10,6 +10,7 @@
 
 
 #include <iosfwd>                            // for ofstream, ostream
+#include <future>                            // for future
 #include <map>                               // for map, map<>::value_compare
 #include <memory>                            // for shared_ptr
 #include <new>                               // for operator new[]
@@ -176,6 +177,18 @@ protected:
      */
     void find_observe_point(Mesh &mesh);
 
+    /**
+     * Same as previous method, initial candidate elements are given by @p candidate_list found
+     * in BIH tree for the point returned by @p bih_search_point (see Observe::find_observe_points).
+     */
+    void find_observe_point(Mesh &mesh, const std::vector<unsigned int> &candidate_list);
+
+    /// Print warning if the input point is too distant from the observe element (called after the search on all processes).
+    void check_distance(Mesh &mesh);
+
+    /// Return point used for search of initial candidates in BIH tree (input point projected to the tree box).
+    arma::vec3 bih_search_point(Mesh &mesh) const;
+
     /**
      * Output the observe point information into a YAML formated stream, indent by
      * given number of spaces + "- ".
@@ -311,9 +324,25 @@ public:
 
 
 protected:
+    /**
+     * Find observe elements of all points.
+     *
+     * Points are searched in blocks distributed over processes (the mesh is known on every process),
+     * initial candidates of the local block are found by one pass through the BIH tree,
+     * results are exchanged by one collective call. Points that fail are searched again on all processes
+     * in order to throw the same exception everywhere.
+     */
+    void find_observe_points(Mesh &mesh);
+
     /// Effectively writes the data into the observe stream.
     void flush_values();
 
+    /**
+     * Write gathered values of @p times to the observe stream. Called on the first process in a separate thread
+     * so the computation can continue, only one write is in progress at a time.
+     */
+    void write_values(std::vector<double> times, std::vector<OutputDataPtr> serial_data);
+
     /// Maximal size of observe values times vector
     static const unsigned int max_observe_value_time;
 
@@ -349,6 +378,12 @@ protected:
 	/// Index set assigning to local point index its global index.
     std::vector<LongIdx> point_4_loc_;
 
+    /// Map of local to global indices of values of all time frames, used in gather of the values.
+    std::vector<LongIdx> local_to_global_;
+
+    /// Write of the previous flush, finished before next flush or in destructor.
+    std::future<void> write_future_;
+
 	/// Parallel distribution of observe points.
 	Distribution *point_ds_;
 
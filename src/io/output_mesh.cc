@@ -15,7 +15,10 @@
  * @brief   Classes for auxiliary output mesh.
  */
 
+#include <algorithm>
+#include <thread>
 #include "system/index_types.hh"
+#include "system/system.hh"
 #include "output_mesh.hh"
 #include "output_element.hh"
 #include "mesh/mesh.h"
@@ -29,13 +32,15 @@
 namespace IT=Input::Type;
 
 const IT::Record & OutputMeshBase::get_input_type() {
-    return IT::Record("OutputMesh", "Parameters of the refined output mesh. [Not impemented]")
+    return IT::Record("OutputMesh", "Parameters of the refined output mesh.")
         .declare_key("max_level", IT::Integer(1,20),IT::Default("3"),
             "Maximal level of refinement of the output mesh.")
         .declare_key("refine_by_error", IT::Bool(), IT::Default("false"),
-            "Set true for using ``error_control_field``. Set false for global uniform refinement to max_level.")
+            "Set true for using ``error_control_field``. Set false for global uniform refinement to max_level. "
+            "[Not impemented] Refinement by error is not supported yet, use the global uniform refinement.")
         .declare_key("error_control_field",IT::String(), IT::Default::optional(),
-            "Name of an output field, according to which the output mesh will be refined. The field must be a SCALAR one.")
+            "Name of an output field, according to which the output mesh will be refined. The field must be a SCALAR one. "
+            "[Not impemented]")
         .declare_key("refinement_error_tolerance",IT::Double(0.0), IT::Default("0.01"),
             "Tolerance for element refinement by error. If tolerance is reached, refinement is stopped."
             "Relative difference between error control field and its linear approximation on element is computed"
@@ -368,10 +373,13 @@ OutputMeshDiscontinuous::~OutputMeshDiscontinuous()
 
 template<int dim>
 void OutputMeshDiscontinuous::refine_aux_element(const OutputMeshDiscontinuous::AuxElement& aux_element,
-                                                 std::vector< OutputMeshDiscontinuous::AuxElement >& refinement,
+                                                 std::vector<double>& refinement,
                                                  const ElementAccessor<spacedim> &ele_acc)
 {
     static const unsigned int n_subelements = 1 << dim;  //2^dim
+    static const unsigned int n_old_nodes = RefElement<dim>::n_nodes,
+                              n_new_nodes = RefElement<dim>::n_lines, // new points are in the center of lines
+                              n_ele_coords = n_old_nodes*spacedim;
     
 // The refinement of elements for the output mesh is done using edge splitting
 // technique (so called red refinement). Since we use this only for better output
@@ -445,128 +453,163 @@ void OutputMeshDiscontinuous::refine_aux_element(const OutputMeshDiscontinuous::
          6, 5, 7, 4,
          5, 6, 7, 9}
     };
-//     DBGMSG("level = %d, %d\n", aux_element.level, max_refinement_level_);
- 
+
     ASSERT_EQ(dim, aux_element.nodes.size()-1);
-    
-    // if not refining any further, push into final vector
-    if( ! refinement_criterion(aux_element, ele_acc) ) {
-        refinement.push_back(aux_element);
-        return;
-    }
-    
-    std::vector<AuxElement> subelements(n_subelements);
-    
-    const unsigned int n_old_nodes = RefElement<dim>::n_nodes,
-                       n_new_nodes = RefElement<dim>::n_lines; // new points are in the center of lines
-    
-    // auxiliary vectors
-    std::vector<Space<spacedim>::Point> nodes = aux_element.nodes;
-    
-    nodes.reserve(n_old_nodes+n_new_nodes);
 
-    // create new points in the element
-    for(unsigned int e=0; e < n_new_nodes; e++)
-    {
-        Space<spacedim>::Point p = nodes[RefElement<dim>::interact(Interaction<0,1>(e))[0]]
-                                  +nodes[RefElement<dim>::interact(Interaction<0,1>(e))[1]];
-        nodes.push_back( p / 2.0);
-        //nodes.back().print();
-    }
-    
-    unsigned int diagonal = 0;
-    // find shortest diagonal: [0]:4-9, [1]:5-8 or [2]:6-7
-    if(dim == 3){
-        double min_diagonal = arma::norm(nodes[4]-nodes[9],2);
-        double d = arma::norm(nodes[5]-nodes[8],2);
-        if(d < min_diagonal){
-            min_diagonal = d;
-            diagonal = 1;
-        }
-        d = arma::norm(nodes[6]-nodes[7],2);
-        if(d < min_diagonal){
-            min_diagonal = d;
-            diagonal = 2;
-        }
-    }
-    
-    for(unsigned int i=0; i < n_subelements; i++)
+    // sub-elements of the current level: node coordinates and flags of sub-elements not yet final
+    std::vector<double> current(n_ele_coords), next;
+    for(unsigned int j=0; j < n_old_nodes; j++)
+        for(unsigned int k=0; k < spacedim; k++)
+            current[j*spacedim + k] = aux_element.nodes[j][k];
+    std::vector<bool> refine(1, true), next_refine;
+
+    // auxiliary vector of nodes of refined element
+    std::vector<Space<spacedim>::Point> nodes(n_old_nodes+n_new_nodes);
+
+    for(unsigned int level = aux_element.level; ; level++)
     {
-        AuxElement& sub_ele = subelements[i];
-        sub_ele.nodes.resize(n_old_nodes);
-        sub_ele.level = aux_element.level+1;
-        
-        // over nodes
-        for(unsigned int j=0; j < n_old_nodes; j++)
+        refinement_criterion(current, n_old_nodes, level, refine, ele_acc);
+        unsigned int n_refined = std::count(refine.begin(), refine.end(), true);
+        if(n_refined == 0) break;
+
+        const unsigned int n_current = refine.size();
+        next.clear();
+        next.reserve(current.size() + n_refined*(n_subelements-1)*n_ele_coords);
+        next_refine.clear();
+        next_refine.reserve(n_current + n_refined*(n_subelements-1));
+
+        for(unsigned int i_ele=0; i_ele < n_current; i_ele++)
         {
-            unsigned int conn_id = (n_old_nodes)*i + j;
-            sub_ele.nodes[j] = nodes[conn[dim+diagonal][conn_id]];
+            const double *ele_coords = &current[i_ele*n_ele_coords];
+
+            // final sub-element is kept at its position
+            if( ! refine[i_ele] ) {
+                next.insert(next.end(), ele_coords, ele_coords+n_ele_coords);
+                next_refine.push_back(false);
+                continue;
+            }
+
+            for(unsigned int j=0; j < n_old_nodes; j++)
+                for(unsigned int k=0; k < spacedim; k++)
+                    nodes[j][k] = ele_coords[j*spacedim + k];
+
+            // create new points in the element
+            for(unsigned int e=0; e < n_new_nodes; e++)
+            {
+                nodes[n_old_nodes+e] = ( nodes[RefElement<dim>::interact(Interaction<0,1>(e))[0]]
+                                        +nodes[RefElement<dim>::interact(Interaction<0,1>(e))[1]] ) / 2.0;
+            }
+
+            unsigned int diagonal = 0;
+            // find shortest diagonal: [0]:4-9, [1]:5-8 or [2]:6-7
+            if(dim == 3){
+                double min_diagonal = arma::norm(nodes[4]-nodes[9],2);
+                double d = arma::norm(nodes[5]-nodes[8],2);
+                if(d < min_diagonal){
+                    min_diagonal = d;
+                    diagonal = 1;
+                }
+                d = arma::norm(nodes[6]-nodes[7],2);
+                if(d < min_diagonal){
+                    min_diagonal = d;
+                    diagonal = 2;
+                }
+            }
+
+            // children replace the refined sub-element in place
+            for(unsigned int i=0; i < n_subelements; i++)
+            {
+                // over nodes
+                for(unsigned int j=0; j < n_old_nodes; j++)
+                {
+                    unsigned int conn_id = (n_old_nodes)*i + j;
+                    const Space<spacedim>::Point &node = nodes[conn[dim+diagonal][conn_id]];
+                    for(unsigned int k=0; k < spacedim; k++) next.push_back(node[k]);
+                }
+                next_refine.push_back(true);
+            }
         }
-        refine_aux_element<dim>(sub_ele, refinement, ele_acc);
+        current.swap(next);
+        refine.swap(next_refine);
     }
+
+    refinement.insert(refinement.end(), current.begin(), current.end());
 }
 
 
 
-template void OutputMeshDiscontinuous::refine_aux_element<1>(const OutputMeshDiscontinuous::AuxElement&,std::vector< OutputMeshDiscontinuous::AuxElement >&, const ElementAccessor<spacedim> &);
-template void OutputMeshDiscontinuous::refine_aux_element<2>(const OutputMeshDiscontinuous::AuxElement&,std::vector< OutputMeshDiscontinuous::AuxElement >&, const ElementAccessor<spacedim> &);
-template void OutputMeshDiscontinuous::refine_aux_element<3>(const OutputMeshDiscontinuous::AuxElement&,std::vector< OutputMeshDiscontinuous::AuxElement >&, const ElementAccessor<spacedim> &);
+template void OutputMeshDiscontinuous::refine_aux_element<1>(const OutputMeshDiscontinuous::AuxElement&,std::vector<double>&, const ElementAccessor<spacedim> &);
+template void OutputMeshDiscontinuous::refine_aux_element<2>(const OutputMeshDiscontinuous::AuxElement&,std::vector<double>&, const ElementAccessor<spacedim> &);
+template void OutputMeshDiscontinuous::refine_aux_element<3>(const OutputMeshDiscontinuous::AuxElement&,std::vector<double>&, const ElementAccessor<spacedim> &);
 
 
-bool OutputMeshDiscontinuous::refinement_criterion(const AuxElement& aux_ele,
+void OutputMeshDiscontinuous::refinement_criterion(const std::vector<double> &nodes, unsigned int n_ele_nodes,
+                                                   unsigned int level, std::vector<bool> &refine,
                                                    const ElementAccessor<spacedim> &ele_acc)
 {
     // check refinement criteria:
-    
-    //first check max. level
-    bool refine = refinement_criterion_uniform(aux_ele);
-    
-    //if max. level not reached and refinement by error is set
-    if(refine && refine_by_error_)
-    {
-        // compute centre of aux element
-        Space<spacedim>::Point centre({0,0,0});
-        for(auto& v : aux_ele.nodes ) centre += v;
-        centre = centre/aux_ele.nodes.size();
-        return refinement_criterion_error(aux_ele, centre, ele_acc);
+
+    //first check max. level, same for all sub-elements of the level
+    if( ! refinement_criterion_uniform(level) ) {
+        std::fill(refine.begin(), refine.end(), false);
+        return;
     }
-    
-    return refine;
+
+    //if max. level not reached and refinement by error is set
+    if(refine_by_error_)
+        refinement_criterion_error(nodes, n_ele_nodes, refine, ele_acc);
 }
 
-bool OutputMeshDiscontinuous::refinement_criterion_uniform(const OutputMeshDiscontinuous::AuxElement& ele)
+bool OutputMeshDiscontinuous::refinement_criterion_uniform(unsigned int level)
 {
-    return (ele.level < max_level_);
+    return (level < max_level_);
 }
 
-bool OutputMeshDiscontinuous::refinement_criterion_error(const OutputMeshDiscontinuous::AuxElement& ele,
-                                            const Space<spacedim>::Point &centre,
-                                            const ElementAccessor<spacedim> &ele_acc
-                                           )
+void OutputMeshDiscontinuous::refinement_criterion_error(const std::vector<double> &nodes, unsigned int n_ele_nodes,
+                                                         std::vector<bool> &refine,
+                                                         const ElementAccessor<spacedim> &ele_acc)
 {
     ASSERT(error_control_field_func_).error("Error control field not set!");
 
-    // evaluate at nodes and center in a single call
-    std::vector<double> val_list(ele.nodes.size()+1);
-    Armor::array point_list(spacedim,1,1+ele.nodes.size());
-    point_list.set(0) = centre;
-    unsigned int i=0;
-    for (auto node : ele.nodes) point_list.set(++i) = node;
+    const unsigned int n_ele_points = n_ele_nodes+1;
+    unsigned int n_refine = std::count(refine.begin(), refine.end(), true);
+    if(n_refine == 0) return;
+
+    // evaluate at centres and nodes of all flagged sub-elements in a single call
+    std::vector<double> val_list(n_refine*n_ele_points);
+    Armor::array point_list(spacedim,1,n_refine*n_ele_points);
+    unsigned int i_point = 0;
+    for(unsigned int i_ele=0; i_ele < refine.size(); i_ele++)
+    {
+        if( ! refine[i_ele] ) continue;
+        const double *ele_coords = &nodes[i_ele*n_ele_nodes*spacedim];
+        Space<spacedim>::Point centre({0,0,0});
+        for(unsigned int j=0; j < n_ele_nodes; j++)
+            for(unsigned int k=0; k < spacedim; k++)
+                centre[k] += ele_coords[j*spacedim + k];
+        point_list.set(i_point++) = centre / n_ele_nodes;
+        for(unsigned int j=0; j < n_ele_nodes; j++)
+            point_list.set(i_point++) = Space<spacedim>::Point({ele_coords[j*spacedim], ele_coords[j*spacedim+1], ele_coords[j*spacedim+2]});
+    }
     error_control_field_func_(point_list, ele_acc, val_list);
 
     //TODO: compute L1 or L2 error using standard quadrature
-    
-    //compare average value at nodes with value at center
-    
-    double average_val = 0.0;
-    for(unsigned int i=1; i<ele.nodes.size()+1; ++i)//(double& v: nodes_val)
-        average_val += val_list[i];
-    average_val = average_val / ele.nodes.size();
-    
-    double diff = std::abs((average_val - val_list[0])/val_list[0]);
-//     DebugOut().fmt("diff: {}  {}  {}\n", diff, average_val, val_list[0]);
-    return ( diff > refinement_error_tolerance_);
 
+    //compare average value at nodes with value at center
+    i_point = 0;
+    for(unsigned int i_ele=0; i_ele < refine.size(); i_ele++)
+    {
+        if( ! refine[i_ele] ) continue;
+        double centre_val = val_list[i_point];
+        double average_val = 0.0;
+        for(unsigned int j=1; j < n_ele_points; ++j)
+            average_val += val_list[i_point+j];
+        average_val = average_val / n_ele_nodes;
+        i_point += n_ele_points;
+
+        double diff = std::abs((average_val - centre_val)/centre_val);
+        refine[i_ele] = ( diff > refinement_error_tolerance_);
+    }
 }
 
 
@@ -622,86 +665,98 @@ std::shared_ptr<ElementDataCache<unsigned int>> OutputMeshDiscontinuous::make_se
 }
 
 
+void OutputMeshDiscontinuous::refine_local_elements(unsigned int begin, unsigned int end, RefinedChunk &chunk)
+{
+    LongIdx *el_4_loc = orig_mesh_->get_el_4_loc();
+    chunk.n_sub_elements.reserve(end - begin);
+
+    AuxElement aux_ele;
+    for (unsigned int loc_el = begin; loc_el < end; loc_el++) {
+        auto ele = orig_mesh_->element_accessor( el_4_loc[loc_el] );
+        const unsigned int dim = ele->dim();
+
+        aux_ele.nodes.resize(ele->n_nodes());
+        aux_ele.level = 0;
+        for (unsigned int li=0; li<ele->n_nodes(); li++) {
+            aux_ele.nodes[li] = *ele.node(li);
+        }
+
+        unsigned int n_coords = chunk.nodes.size();
+        switch(dim){
+            case 1: this->refine_aux_element<1>(aux_ele, chunk.nodes, ele); break;
+            case 2: this->refine_aux_element<2>(aux_ele, chunk.nodes, ele); break;
+            case 3: this->refine_aux_element<3>(aux_ele, chunk.nodes, ele); break;
+            default: ASSERT_PERMANENT(0).error("Should not happen.\n");
+        }
+        chunk.n_sub_elements.push_back( (chunk.nodes.size() - n_coords) / ((dim+1)*spacedim) );
+    }
+}
+
+
 void OutputMeshDiscontinuous::create_refined_sub_mesh()
 {
     ASSERT( !is_created() ).error("Multiple initialization of OutputMesh!\n");
 
     DebugOut() << "Create refined discontinuous submesh containing only local elements.";
-    // initial guess of size: n_elements
     nodes_ = std::make_shared<ElementDataCache<double>>("",(unsigned int)ElementDataCacheBase::N_VECTOR,0);
     connectivity_ = std::make_shared<ElementDataCache<unsigned int>>("connectivity",(unsigned int) ElementDataCacheBase::N_SCALAR,0);
     offsets_ = std::make_shared<ElementDataCache<unsigned int>>("offsets",(unsigned int) ElementDataCacheBase::N_SCALAR,0);
     orig_element_indices_ = std::make_shared<std::vector<unsigned int>>();
 
-    // index of last node added; set at the end of original ones
-    unsigned int last_offset = 0;
-
-    auto &node_vec = *( nodes_->get_data().get() );
-    auto &conn_vec = *( connectivity_->get_data().get() );
-    auto &offset_vec = *( offsets_->get_data().get() );
-
-    node_vec.reserve(4*orig_mesh_->n_nodes());
-    conn_vec.reserve(4*4*orig_mesh_->n_elements());
-    offset_vec.reserve(4*orig_mesh_->n_elements()+4);
-    offset_vec.push_back(0);
-
     LongIdx *el_4_loc = orig_mesh_->get_el_4_loc();
     const unsigned int n_local_elements = orig_mesh_->get_el_ds()->lsize();
 
-    for (unsigned int loc_el = 0; loc_el < n_local_elements; loc_el++) {
-    	auto ele = orig_mesh_->element_accessor( el_4_loc[loc_el] );
-    	const unsigned int
-            dim = ele->dim(),
-            ele_idx = ele.idx();
-
-        AuxElement aux_ele;
-        aux_ele.nodes.resize(ele->n_nodes());
-        aux_ele.level = 0;
-
-        unsigned int li;
-        for (li=0; li<ele->n_nodes(); li++) {
-            aux_ele.nodes[li] = *ele.node(li);
-        }
+    // Local elements are refined in contiguous chunks by threads. Error control field
+    // is not thread safe, refinement by error is performed by the single thread.
+    unsigned int n_threads = 1;
+    if (!refine_by_error_)
+        n_threads = n_local_threads(n_local_elements);
+    std::vector<RefinedChunk> chunks(n_threads);
+    auto refine_chunk = [&](unsigned int i_thread) {
+        this->refine_local_elements(i_thread * n_local_elements / n_threads,
+                                    (i_thread+1) * n_local_elements / n_threads, chunks[i_thread]);
+    };
 
-        std::vector<AuxElement> refinement;
+    std::vector<std::thread> threads;
+    for (unsigned int i_thread = 1; i_thread < n_threads; ++i_thread)
+        threads.push_back( std::thread(refine_chunk, i_thread) );
+    refine_chunk(0);
+    for (auto &thread : threads) thread.join();
 
-        switch(dim){
-            case 1: this->refine_aux_element<1>(aux_ele, refinement, ele); break;
-            case 2: this->refine_aux_element<2>(aux_ele, refinement, ele); break;
-            case 3: this->refine_aux_element<3>(aux_ele, refinement, ele); break;
-            default: ASSERT_PERMANENT(0).error("Should not happen.\n");
-        }
+    // gather chunks, coords and connectivity are continous inside element
+    auto &node_vec = *( nodes_->get_data().get() );
+    auto &conn_vec = *( connectivity_->get_data().get() );
+    auto &offset_vec = *( offsets_->get_data().get() );
 
-        //skip unrefined element
-//         if(refinement.size() < 2) continue;
-        unsigned int node_offset = node_vec.size(),
-                     con_offset = conn_vec.size();
-        node_vec.resize(node_vec.size() + (refinement.size() * (dim+1))*spacedim);
-        conn_vec.resize(conn_vec.size() + refinement.size()*(dim+1));
-//         orig_element_indices_->resize(orig_element_indices_->size() + refinement.size()*(dim+1));
-
-//         DebugOut() << "ref size = " << refinement.size() << "\n";
-        //gather coords and connectivity (in a continous way inside element)
-        for(unsigned int i=0; i < refinement.size(); i++)
-        {
-            last_offset += dim+1;
-            offset_vec.push_back(last_offset);
-            (*orig_element_indices_).push_back(ele_idx);
-            for(unsigned int j=0; j < dim+1; j++)
-            {
-                unsigned int con = i*(dim+1) + j;
-                conn_vec[con_offset + con] = con_offset + con;
+    unsigned int n_coords = 0, n_sub_elements = 0;
+    for (auto &chunk : chunks) {
+        n_coords += chunk.nodes.size();
+        for (unsigned int n_sub : chunk.n_sub_elements) n_sub_elements += n_sub;
+    }
+    node_vec.reserve(n_coords);
+    conn_vec.resize(n_coords / spacedim);
+    offset_vec.reserve(n_sub_elements+1);
+    orig_element_indices_->reserve(n_sub_elements);
+    offset_vec.push_back(0);
 
-                for(unsigned int k=0; k < spacedim; k++) {
-                    node_vec[node_offset + con*spacedim + k] = refinement[i].nodes[j][k];
-                }
+    // index of last node added
+    unsigned int last_offset = 0;
+    unsigned int loc_el = 0;
+    for (auto &chunk : chunks) {
+        node_vec.insert(node_vec.end(), chunk.nodes.begin(), chunk.nodes.end());
+        for (unsigned int n_sub : chunk.n_sub_elements) {
+            auto ele = orig_mesh_->element_accessor( el_4_loc[loc_el++] );
+            const unsigned int dim = ele->dim(), ele_idx = ele.idx();
+            for (unsigned int i=0; i < n_sub; i++) {
+                last_offset += dim+1;
+                offset_vec.push_back(last_offset);
+                orig_element_indices_->push_back(ele_idx);
             }
         }
+        // release memory of the chunk
+        std::vector<double>().swap(chunk.nodes);
     }
-
-    conn_vec.shrink_to_fit();
-    node_vec.shrink_to_fit();
-    offset_vec.shrink_to_fit();
+    for (unsigned int i=0; i<conn_vec.size(); ++i) conn_vec[i] = i;
 
     connectivity_->set_n_values(conn_vec.size());
     nodes_->set_n_values(node_vec.size() / spacedim);
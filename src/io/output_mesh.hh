@@ -297,25 +297,53 @@ protected:
         unsigned int level;
     };
 
-    ///Performs the actual refinement of AuxElement. Recurrent.
+    /// Refined local elements of one thread, sub-elements are stored in flat buffer.
+    struct RefinedChunk {
+        /// Node coordinates of all sub-elements [n_sub_elements x (dim+1) x spacedim].
+        std::vector<double> nodes;
+        /// Number of sub-elements of every refined element of the chunk.
+        std::vector<unsigned int> n_sub_elements;
+    };
+
+    /**
+     * Performs the actual refinement of AuxElement.
+     *
+     * Refinement is done level by level, all sub-elements of one level are stored in a flat buffer
+     * and the refinement criterion is evaluated for all of them at once. Refined sub-elements are
+     * replaced in place by their children, so the order of the resulting sub-elements is the same
+     * as the order given by the recursive refinement. Node coordinates of resulting sub-elements
+     * are appended to @p refinement.
+     */
     template<int dim>
     void refine_aux_element(const AuxElement& aux_element,
-                            std::vector< AuxElement >& refinement,
+                            std::vector<double>& refinement,
                             const ElementAccessor<spacedim> &ele_acc
                            );
-    
-    /// Collects different refinement criteria results.
-    bool refinement_criterion(const AuxElement& ele,
-                              const ElementAccessor<spacedim> &ele_acc);
-    
+
+    /// Refines local elements in range [@p begin, @p end), results are stored to @p chunk.
+    void refine_local_elements(unsigned int begin, unsigned int end, RefinedChunk &chunk);
+
+    /**
+     * Collects different refinement criteria results.
+     *
+     * @param nodes   Flat buffer of node coordinates of sub-elements of given @p level.
+     * @param refine  Flags of sub-elements, on input true for sub-elements which are not final,
+     *                on output true for sub-elements to be refined.
+     */
+    void refinement_criterion(const std::vector<double> &nodes, unsigned int n_ele_nodes, unsigned int level,
+                              std::vector<bool> &refine, const ElementAccessor<spacedim> &ele_acc);
+
     /// Refinement flag - checks only maximal level of refinement.
-    bool refinement_criterion_uniform(const AuxElement& ele);
-    
-    /// Refinement flag - measures discretisation error according to error control field.
-    bool refinement_criterion_error(const AuxElement& ele,
-                                    const Space<spacedim>::Point &centre,
-                                    const ElementAccessor<spacedim> &ele_acc
-                                   );
+    bool refinement_criterion_uniform(unsigned int level);
+
+    /**
+     * Refinement flag - measures discretisation error according to error control field.
+     *
+     * Error control field is evaluated at nodes and centres of all flagged sub-elements in a single call.
+     * Flag is reset for sub-elements with error under the tolerance.
+     */
+    void refinement_criterion_error(const std::vector<double> &nodes, unsigned int n_ele_nodes,
+                                    std::vector<bool> &refine, const ElementAccessor<spacedim> &ele_acc);
 
     /// Implements OutputMeshBase::construct_mesh
     std::shared_ptr<OutputMeshBase> construct_mesh() override;
@@ -23,6 +23,7 @@
 #include "output_time.impl.hh"
 #include "output_vtk.hh"
 #include "output_msh.hh"
+#include "output_xdmf.hh"
 #include "output_mesh.hh"
 #include "io/output_time_set.hh"
 #include "io/observe.hh"
@@ -31,6 +32,7 @@
 
 FLOW123D_FORCE_LINK_IN_PARENT(vtk)
 FLOW123D_FORCE_LINK_IN_PARENT(gmsh)
+FLOW123D_FORCE_LINK_IN_PARENT(xdmf)
 
 
 namespace IT = Input::Type;
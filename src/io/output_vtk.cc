@@ -22,11 +22,14 @@
 #include "mesh/mesh.h"
 
 #include <limits.h>
+#include <thread>
 #include "input/factory.hh"
 #include "input/accessors_forward.hh"
 #include "system/file_path.hh"
+#include "system/system.hh"
 #include "tools/time_governor.hh"
 #include "la/distribution.hh"
+#include "system/sys_profiler.hh"
 
 #include "config.h"
 
@@ -44,6 +47,16 @@ const Record & OutputVTK::get_input_type() {
 		// The parallel or serial variant
 		.declare_key("parallel", Bool(), Default("false"),
 			"Parallel or serial version of file format.")
+		.declare_key("single_precision", Bool(), Default("false"),
+			"Write floating point field data as Float32 in binary variants of the format. "
+			"Halves the size of output files, geometry and native data are always written in double precision.")
+		.declare_key("quantization_error", Double(0.0), Default("0"),
+			"Maximal absolute error of lossy quantization of floating point field data. "
+			"Values are rounded to multiples of twice the given error, that improves compression "
+			"of the 'binary_zlib' variant. Zero value turns the quantization off.")
+		.declare_key("compression_level", Integer(1, 9), Default("9"),
+			"Level of ZLib compression of the 'binary_zlib' variant, from 1 (fastest) to 9 (best compression). "
+			"Blocks of appended data are compressed in parallel threads.")
 		.close();
 }
 
@@ -71,6 +84,7 @@ const std::vector<std::string> OutputVTK::formats = { "ascii", "appended", "appe
 
 
 OutputVTK::OutputVTK()
+: single_precision_(false), quantization_error_(0.0), compression_level_(Z_BEST_COMPRESSION)
 {
     this->enable_refinement_ = true;
 }
@@ -96,6 +110,9 @@ void OutputVTK::init_from_input(const std::string &equation_name,
     auto format_rec = (Input::Record)(input_record_.val<Input::AbstractRecord>("format"));
     variant_type_ = format_rec.val<VTKVariant>("variant");
     this->parallel_ = format_rec.val<bool>("parallel");
+    this->single_precision_ = format_rec.val<bool>("single_precision");
+    this->quantization_error_ = format_rec.val<double>("quantization_error");
+    this->compression_level_ = format_rec.val<int>("compression_level");
     this->fix_main_file_extension(".pvd");
 
     if(this->rank_ == 0) {
@@ -271,14 +288,12 @@ std::shared_ptr<ElementDataCache<unsigned int>> OutputVTK::fill_element_types_da
 
 
 
-void OutputVTK::write_vtk_data(OutputTime::OutputDataPtr output_data, unsigned int start)
+void OutputVTK::write_vtk_data(ostream &file, OutputTime::OutputDataPtr output_data, unsigned int start)
 {
     // names of types in DataArray section
 	static const std::vector<std::string> types = {
         "Int8", "UInt8", "Int16", "UInt16", "Int32", "UInt32", "Float32", "Float64" };
 
-    ofstream &file = this->_data_file;
-
     file    << "<DataArray type=\"" << types[output_data->vtk_type()] << "\" ";
     // possibly write name
     if( ! output_data->field_input_name().empty())
@@ -306,87 +321,93 @@ void OutputVTK::write_vtk_data(OutputTime::OutputDataPtr output_data, unsigned i
     	if ( this->variant_type_ == VTKVariant::VARIANT_BINARY_UNCOMPRESSED ) {
     		output_data->print_binary_all( appended_data_, true, start );
     	} else { // ZLib compression
-    		stringstream uncompressed_data, compressed_data;
-    		output_data->print_binary_all( uncompressed_data, false, start );
-    		this->compress_data(uncompressed_data, compressed_data);
-    		appended_data_ << compressed_data.str();
+    		std::string buffer;
+    		const char *data;
+    		std::size_t n_bytes;
+    		this->binary_data(output_data, start, buffer, data, n_bytes);
+    		this->compress_data(data, n_bytes, appended_data_);
     	}
     }
 
 }
 
 
-void OutputVTK::compress_data(stringstream &uncompressed_stream, stringstream &compressed_stream) {
+void OutputVTK::binary_data(OutputDataPtr output_data, unsigned int start, std::string &buffer,
+		const char *&data, std::size_t &n_bytes)
+{
+	// size of values of VTK types
+	static const std::vector<std::size_t> type_sizes = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+	std::size_t n_values = output_data->n_values() * output_data->n_comp();
+	std::size_t value_size = type_sizes[output_data->vtk_type()];
+	std::size_t raw_size;
+	const char *raw = output_data->raw_data(raw_size);
+	if (raw_size == n_values * value_size) {
+		// storage of cache is used directly
+		std::size_t start_bytes = (std::size_t)start * output_data->n_comp() * value_size;
+		data = raw + start_bytes;
+		n_bytes = raw_size - start_bytes;
+	} else {
+		// values are converted (e.g. to single precision)
+		ostringstream ss;
+		output_data->print_binary_all( ss, false, start );
+		buffer = ss.str();
+		data = buffer.data();
+		n_bytes = buffer.size();
+	}
+}
+
+
+void OutputVTK::compress_data(const char *data, std::size_t n_bytes, ostream &compressed_stream) {
     // size of block of compressed data.
 	static const size_t BUF_SIZE = 32 * 1024;
 
-	string uncompressed_string = uncompressed_stream.str();  // full uncompressed string
-	zlib_ulong uncompressed_size = uncompressed_string.size();    // size of uncompressed string
-	stringstream compressed_data;                            // helper stream stores blocks of compress data
-
+	zlib_ulong uncompressed_size = n_bytes;
 	zlib_ulong count_of_blocks = (uncompressed_size + BUF_SIZE - 1) / BUF_SIZE;
 	zlib_ulong last_block_size = (uncompressed_size % BUF_SIZE);
 	compressed_stream.write(reinterpret_cast<const char*>(&count_of_blocks), sizeof(unsigned long long int));
 	compressed_stream.write(reinterpret_cast<const char*>(&BUF_SIZE), sizeof(unsigned long long int));
 	compressed_stream.write(reinterpret_cast<const char*>(&last_block_size), sizeof(unsigned long long int));
 
-	for (zlib_ulong i=0; i<count_of_blocks; ++i) {
-		// get block of data for compression
-		std::string data_block = uncompressed_string.substr(i*BUF_SIZE, BUF_SIZE);
-		zlib_ulong data_block_size = data_block.size();
-
-		std::vector<uint8_t> buffer;
-		uint8_t temp_buffer[BUF_SIZE];
-
-		// set zlib object
-		z_stream strm;
-		strm.zalloc = 0;
-		strm.zfree = 0;
-		strm.next_in = reinterpret_cast<uint8_t *>(&data_block[0]);
-		strm.avail_in = data_block_size;
-		strm.next_out = temp_buffer;
-		strm.avail_out = BUF_SIZE;
-
-		// compression of data
-		deflateInit(&strm, Z_BEST_COMPRESSION);
-		while (strm.avail_in != 0) {
-			int res = deflate(&strm, Z_NO_FLUSH);
-			ASSERT_EQ(res, Z_OK).error();
-			if (strm.avail_out == 0) {
-				buffer.insert(buffer.end(), temp_buffer, temp_buffer + BUF_SIZE);
-				strm.next_out = temp_buffer;
-				strm.avail_out = BUF_SIZE;
-			}
+	// every thread compresses each n_threads-th block, blocks are independent zlib streams
+	std::vector< std::vector<uint8_t> > blocks(count_of_blocks);
+	std::vector<int> block_status(count_of_blocks, Z_OK);
+	unsigned int n_threads = n_local_threads( (unsigned int)count_of_blocks );
+	auto deflate_blocks = [&](unsigned int i_thread) {
+		for (zlib_ulong i = i_thread; i < count_of_blocks; i += n_threads) {
+			zlib_ulong data_block_size = std::min( (zlib_ulong)BUF_SIZE, uncompressed_size - i*BUF_SIZE );
+			zlib_ulong compressed_size = compressBound(data_block_size);
+			blocks[i].resize(compressed_size);
+			block_status[i] = compress2( blocks[i].data(), &compressed_size,
+					reinterpret_cast<const Bytef *>(data + i*BUF_SIZE), data_block_size, compression_level_ );
+			blocks[i].resize(compressed_size);
 		}
-		int deflate_res = Z_OK;
-		while (deflate_res == Z_OK) {
-			if (strm.avail_out == 0) {
-				buffer.insert(buffer.end(), temp_buffer, temp_buffer + BUF_SIZE);
-				strm.next_out = temp_buffer;
-				strm.avail_out = BUF_SIZE;
-			}
-			deflate_res = deflate(&strm, Z_FINISH);
-		}
-		ASSERT_EQ(deflate_res, Z_STREAM_END).error();
-		buffer.insert(buffer.end(), temp_buffer, temp_buffer + BUF_SIZE - strm.avail_out);
-		deflateEnd(&strm);
-
-		// store compress data and its size to streams
-		std::string str(buffer.begin(), buffer.end());
-		zlib_ulong compressed_data_size = str.size();
+	};
+	std::vector<std::thread> threads;
+	for (unsigned int i_thread = 1; i_thread < n_threads; ++i_thread)
+		threads.push_back( std::thread(deflate_blocks, i_thread) );
+	deflate_blocks(0);
+	for (auto &thread : threads) thread.join();
+
+	// store sizes of compressed blocks and compressed data to stream
+	for (zlib_ulong i=0; i<count_of_blocks; ++i) {
+		ASSERT_EQ(block_status[i], Z_OK).error();
+		zlib_ulong compressed_data_size = blocks[i].size();
 		compressed_stream.write(reinterpret_cast<const char*>(&compressed_data_size), sizeof(unsigned long long int));
-		compressed_data << str;
 	}
-	// push compress data to returned stream
-	compressed_stream << compressed_data.str();
+	for (zlib_ulong i=0; i<count_of_blocks; ++i)
+		compressed_stream.write(reinterpret_cast<const char*>(blocks[i].data()), blocks[i].size());
 }
 
 
 void OutputVTK::write_vtk_field_data(OutputDataFieldVec &output_data_vec)
 {
     for(OutputDataPtr data :  output_data_vec)
-        if( ! data->is_dummy())
-            write_vtk_data(data);
+        if( ! data->is_dummy()) {
+            if (quantization_error_ > 0.0) data->quantize(quantization_error_);
+            if (single_precision_ && this->variant_type_ != VTKVariant::VARIANT_ASCII) data->set_single_precision();
+            write_vtk_data(this->_data_file, data);
+        }
 }
 
 
@@ -503,10 +524,11 @@ void OutputVTK::write_vtk_native_data(void)
         	if ( this->variant_type_ == VTKVariant::VARIANT_BINARY_UNCOMPRESSED ) {
         		output_data->print_binary_all( appended_data_ );
         	} else { // ZLib compression
-        		stringstream uncompressed_data, compressed_data;
-        		output_data->print_binary_all( uncompressed_data, false );
-        		this->compress_data(uncompressed_data, compressed_data);
-        		appended_data_ << compressed_data.str();
+        		std::string buffer;
+        		const char *data;
+        		std::size_t n_bytes;
+        		this->binary_data(output_data, 0, buffer, data, n_bytes);
+        		this->compress_data(data, n_bytes, appended_data_);
         	}
         }
     }
@@ -532,10 +554,45 @@ void OutputVTK::write_vtk_vtu_tail(void)
 }
 
 
+void OutputVTK::write_vtk_geometry(void)
+{
+    // output mesh is not changed during the run, geometry is formatted (and compressed) only once
+    if (geometry_nodes_ != this->nodes_) {
+        START_TIMER("OutputVTK::make_geometry_cache");
+        ostringstream geometry;
+        geometry.precision(this->precision_);
+
+        geometry << "<Points>" << endl;
+            write_vtk_data(geometry, this->nodes_);
+        geometry << "</Points>" << endl;
+
+        geometry << "<Cells>" << endl;
+            write_vtk_data(geometry, this->connectivity_);
+            write_vtk_data(geometry, this->offsets_, 1);
+            auto types = fill_element_types_data();
+            write_vtk_data(geometry, types );
+        geometry << "</Cells>" << endl;
+
+        geometry_xml_ = geometry.str();
+        geometry_appended_ = appended_data_.str();
+        geometry_nodes_ = this->nodes_;
+    } else {
+        // geometry is placed at the beginning of appended data, offsets are same in all frames
+        appended_data_ << geometry_appended_;
+    }
+
+    this->_data_file << geometry_xml_;
+}
+
+
 void OutputVTK::write_vtk_vtu(void)
 {
     ofstream &file = this->_data_file;
 
+    // appended data of the previous frame
+    appended_data_.str("");
+    appended_data_.clear();
+
     /* Write header */
     this->write_vtk_vtu_head();
 
@@ -543,18 +600,8 @@ void OutputVTK::write_vtk_vtu(void)
     file << "<Piece NumberOfPoints=\"" << this->nodes_->n_values()
               << "\" NumberOfCells=\"" << this->offsets_->n_values()-1 <<"\">" << endl;
 
-    /* Write VTK Geometry */
-    file << "<Points>" << endl;
-        write_vtk_data(this->nodes_);
-    file << "</Points>" << endl;
-
-    /* Write VTK Topology */
-    file << "<Cells>" << endl;
-        write_vtk_data(this->connectivity_);
-        write_vtk_data(this->offsets_, 1);
-        auto types = fill_element_types_data();
-       	write_vtk_data( types );
-    file << "</Cells>" << endl;
+    /* Write VTK Geometry and Topology */
+    this->write_vtk_geometry();
 
     /* Write VTK scalar and vector data on nodes to the file */
     this->write_vtk_node_data();
@@ -160,9 +160,17 @@ protected:
     void write_vtk_field_data(OutputDataFieldVec &output_data_map);
 
     /**
-     * Write output data stored in OutputData vector to output stream
+     * Write output data stored in OutputData vector to output stream @p file
      */
-    void write_vtk_data(OutputDataPtr output_data, unsigned int start = 0);
+    void write_vtk_data(ostream &file, OutputDataPtr output_data, unsigned int start = 0);
+
+    /**
+     * \brief Write geometry and topology of the output mesh to the VTK file (.vtu)
+     *
+     * Geometry is formatted (and compressed) only at the first time frame, next frames
+     * reuse the cached XML and appended data byte-for-byte.
+     */
+    void write_vtk_geometry(void);
     
     /**
      * \brief Write names of data sets in @p output_data vector that have value type equal to @p type.
@@ -206,11 +214,20 @@ protected:
    void make_subdirectory();
 
    /**
-    * Compress data stored in @p uncompressed_stream to @p compressed_stream.
+    * Set @p data and @p n_bytes to binary values of @p output_data from value @p start.
+    *
+    * Storage of the cache is used directly, @p buffer holds values only if they are converted
+    * (e.g. to single precision).
+    */
+   void binary_data(OutputDataPtr output_data, unsigned int start, std::string &buffer,
+           const char *&data, std::size_t &n_bytes);
+
+   /**
+    * Compress @p n_bytes of @p data to @p compressed_stream.
     *
-    * Use ZLib compression.
+    * Use ZLib compression, blocks of data are compressed by parallel threads.
     */
-   void compress_data(stringstream &uncompressed_stream, stringstream &compressed_stream);
+   void compress_data(const char *data, std::size_t n_bytes, ostream &compressed_stream);
 
 
    /**
@@ -234,8 +251,26 @@ protected:
    /// Main output file directory
    string main_output_dir_;
 
+   /// Nodes of the output mesh of the cached geometry
+   std::shared_ptr<ElementDataCache<double>> geometry_nodes_;
+
+   /// Cached XML of Points and Cells sections (contains data of the ascii variant)
+   string geometry_xml_;
+
+   /// Cached appended (possibly compressed) data of Points and Cells sections, placed at the beginning of appended data
+   string geometry_appended_;
+
    /// Output format (ascii, binary or binary compressed)
    VTKVariant variant_type_;
+
+   /// Write floating point field data as Float32 (binary variants only)
+   bool single_precision_;
+
+   /// Maximal error of quantization of floating point field data, quantization is off for zero value
+   double quantization_error_;
+
+   /// Level of ZLib compression (binary_zlib variant only)
+   int compression_level_;
 };
 
 #endif /* OUTPUT_VTK_HH_ */
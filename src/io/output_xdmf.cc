@@ -0,0 +1,320 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    output_xdmf.cc
+ * @brief   Output of time series to single binary container described by XDMF file.
+ */
+
+#include "output_xdmf.hh"
+#include "element_data_cache.hh"
+#include "output_mesh.hh"
+
+#include <algorithm>
+#include <vector>
+#include <zlib.h>
+#include "input/factory.hh"
+#include "input/accessors_forward.hh"
+#include "system/file_path.hh"
+#include "system/sys_profiler.hh"
+#include "tools/time_governor.hh"
+
+#include "config.h"
+
+FLOW123D_FORCE_LINK_IN_CHILD(xdmf)
+
+
+using namespace Input::Type;
+
+const Record & OutputXDMF::get_input_type() {
+    return Record("xdmf", "Parameters of xdmf output format. "
+    		"Mesh is written once and data of all time frames are appended to the single binary container (.bin), "
+    		"which is described by XDMF file (.xdmf). Native data of fields are not supported, use the vtk format "
+    		"for output of native data.")
+		// It is derived from abstract class
+		.derive_from(OutputTime::get_input_format_type())
+		.declare_key("variant", OutputXDMF::get_input_type_variant(), Default("\"binary\""),
+			"Variant of storing of datasets in the binary container.")
+		.close();
+}
+
+
+const Selection & OutputXDMF::get_input_type_variant() {
+    return Selection("XDMF variant (binary or binary_zlib)")
+		.add_value(OutputXDMF::VARIANT_BINARY, "binary",
+			"Uncompressed binary datasets.")
+#ifdef FLOW123D_HAVE_ZLIB
+		.add_value(OutputXDMF::VARIANT_BINARY_ZLIB, "binary_zlib",
+			"Binary datasets compressed with ZLib.")
+#endif // FLOW123D_HAVE_ZLIB
+		.close();
+}
+
+
+const int OutputXDMF::registrar = Input::register_class< OutputXDMF >("xdmf") +
+		OutputXDMF::get_input_type().size();
+
+
+
+OutputXDMF::OutputXDMF()
+: variant_type_(VARIANT_BINARY), container_size_(0), native_data_warned_(false)
+{
+    this->enable_refinement_ = true;
+}
+
+
+
+OutputXDMF::~OutputXDMF()
+{
+	// Perform output of last time step
+	this->write_time_frame();
+
+	if (container_.is_open()) container_.close();
+}
+
+
+
+void OutputXDMF::init_from_input(const std::string &equation_name,
+                                 const Input::Record &in_rec,
+                                 const std::shared_ptr<TimeUnitConversion>& time_unit_conv)
+{
+	OutputTime::init_from_input(equation_name, in_rec, time_unit_conv);
+
+    auto format_rec = (Input::Record)(input_record_.val<Input::AbstractRecord>("format"));
+    variant_type_ = format_rec.val<XDMFVariant>("variant");
+    this->fix_main_file_extension(".xdmf");
+    container_name_ = this->_base_filename.stem() + ".bin";
+
+    // output is serial, files are written only by the first process
+    if(this->rank_ == 0) {
+        FilePath container_path({this->_base_filename.parent_path(), container_name_}, FilePath::output_file);
+        try {
+            container_path.open_stream( container_ );
+        } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, input_record_)
+
+        LogOut() << "Writing flow output file: " << this->_base_filename << " ... ";
+    }
+}
+
+
+uint64_t OutputXDMF::append_dataset(const char *data, std::size_t n_bytes)
+{
+	uint64_t seek = container_size_;
+	if (variant_type_ == VARIANT_BINARY) {
+		container_.write(data, n_bytes);
+		container_size_ += n_bytes;
+		return seek;
+	}
+
+	// ZLib compression, data are passed to single zlib stream by chunks
+	std::vector<char> buffer(chunk_size);
+	z_stream strm;
+	strm.zalloc = Z_NULL;
+	strm.zfree = Z_NULL;
+	strm.opaque = Z_NULL;
+	int res = deflateInit(&strm, Z_DEFAULT_COMPRESSION);
+	ASSERT_EQ(res, Z_OK).error();
+
+	std::size_t pos = 0;
+	int flush;
+	do {
+		std::size_t n_chunk = std::min(chunk_size, n_bytes - pos);
+		strm.next_in = reinterpret_cast<Bytef *>( const_cast<char *>(data + pos) );
+		strm.avail_in = n_chunk;
+		pos += n_chunk;
+		flush = (pos == n_bytes) ? Z_FINISH : Z_NO_FLUSH;
+		do {
+			strm.next_out = reinterpret_cast<Bytef *>( buffer.data() );
+			strm.avail_out = chunk_size;
+			res = deflate(&strm, flush);
+			ASSERT(res != Z_STREAM_ERROR).error();
+			std::size_t n_out = chunk_size - strm.avail_out;
+			container_.write(buffer.data(), n_out);
+			container_size_ += n_out;
+		} while (strm.avail_out == 0);
+	} while (flush != Z_FINISH);
+	ASSERT_EQ(res, Z_STREAM_END).error();
+	deflateEnd(&strm);
+
+	return seek;
+}
+
+
+std::string OutputXDMF::data_item(const std::string &dims, ElementDataCacheBase::VTKValueType vtk_type, uint64_t seek)
+{
+	// XDMF number types and precisions of VTK types
+	static const std::vector<std::string> number_types = {
+        "Char", "UChar", "Int", "UInt", "Int", "UInt", "Float", "Float" };
+	static const std::vector<unsigned int> precisions = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+	std::ostringstream ss;
+	ss << "<DataItem Dimensions=\"" << dims << "\" NumberType=\"" << number_types[vtk_type]
+	   << "\" Precision=\"" << precisions[vtk_type] << "\" Format=\"Binary\" Endian=\"Little\" Seek=\"" << seek << "\"";
+	if (variant_type_ == VARIANT_BINARY_ZLIB) ss << " Compression=\"Zlib\"";
+	ss << ">" << container_name_ << "</DataItem>\n";
+	return ss.str();
+}
+
+
+void OutputXDMF::write_mesh(void)
+{
+	START_TIMER("OutputXDMF::write_mesh");
+	auto &offsets = *( this->offsets_->get_data().get() );
+	auto &connectivity = *( this->connectivity_->get_data().get() );
+	unsigned int n_elements = offsets.size()-1;
+
+	// geometry
+	std::ostringstream nodes_data;
+	this->nodes_->print_binary_all(nodes_data, false);
+	std::string nodes_str = nodes_data.str();
+	uint64_t nodes_seek = append_dataset(nodes_str.data(), nodes_str.size());
+
+	// mixed topology: XDMF type of element followed by its nodes, lines need also number of nodes
+	std::vector<unsigned int> topology;
+	topology.reserve(n_elements + connectivity.size() + n_elements);
+	for (unsigned int i=0; i<n_elements; ++i) {
+		unsigned int n_nodes = offsets[i+1]-offsets[i];
+		switch (n_nodes) {
+		case 2:
+			topology.push_back(2); // Polyline
+			topology.push_back(2);
+			break;
+		case 3:
+			topology.push_back(4); // Triangle
+			break;
+		case 4:
+			topology.push_back(6); // Tetrahedron
+			break;
+		default:
+			ASSERT_PERMANENT(false)(n_nodes).error("Unsupported type of element.\n");
+		}
+		topology.insert(topology.end(), connectivity.begin() + offsets[i], connectivity.begin() + offsets[i+1]);
+	}
+	uint64_t topology_seek = append_dataset( reinterpret_cast<const char *>(topology.data()), topology.size()*sizeof(unsigned int) );
+
+	std::ostringstream ss;
+	ss << "<Topology TopologyType=\"Mixed\" NumberOfElements=\"" << n_elements << "\">\n"
+	   << data_item(std::to_string(topology.size()), ElementDataCacheBase::VTK_UINT32, topology_seek)
+	   << "</Topology>\n"
+	   << "<Geometry GeometryType=\"XYZ\">\n"
+	   << data_item(std::to_string(this->nodes_->n_values()) + " 3", ElementDataCacheBase::VTK_FLOAT64, nodes_seek)
+	   << "</Geometry>\n";
+	mesh_xml_ = ss.str();
+	written_nodes_ = this->nodes_;
+}
+
+
+void OutputXDMF::write_attributes(std::ostream &frame, OutputDataFieldVec &output_data_vec, const std::string &center)
+{
+	for(OutputDataPtr output_data : output_data_vec) {
+		if (output_data->is_dummy()) continue;
+
+		std::string attribute_type, dims = std::to_string(output_data->n_values());
+		switch (output_data->n_comp()) {
+		case ElementDataCacheBase::N_SCALAR:
+			attribute_type = "Scalar";
+			break;
+		case ElementDataCacheBase::N_VECTOR:
+			attribute_type = "Vector";
+			dims += " 3";
+			break;
+		case ElementDataCacheBase::N_TENSOR:
+			attribute_type = "Tensor";
+			dims += " 9";
+			break;
+		default:
+			ASSERT_PERMANENT(false)(output_data->n_comp()).error("Unsupported number of components.\n");
+		}
+
+		std::ostringstream data;
+		output_data->print_binary_all(data, false);
+		std::string data_str = data.str();
+		uint64_t seek = append_dataset(data_str.data(), data_str.size());
+
+		frame << "<Attribute Name=\"" << output_data->field_input_name() << "\" AttributeType=\"" << attribute_type
+		      << "\" Center=\"" << center << "\">\n"
+		      << data_item(dims, output_data->vtk_type(), seek)
+		      << "</Attribute>\n";
+	}
+}
+
+
+int OutputXDMF::write_data(void)
+{
+    ASSERT_PTR(this->nodes_).error();
+
+    /* Output of serial format is implemented only in the first process */
+    if (this->rank_ != 0) {
+        return 0;
+    }
+    START_TIMER("OutputXDMF::write_data");
+
+    LogOut() << __func__ << ": Writing output (frame: " << this->current_step
+             << ") to container: " << container_name_ << " ... ";
+
+    // geometry is written only once, frames refer to the same datasets
+    if (written_nodes_ != this->nodes_) this->write_mesh();
+
+    double corrected_time = (isfinite(this->registered_time_)?this->registered_time_:0);
+    corrected_time /= this->time_unit_converter->get_coef();
+
+    std::ostringstream frame;
+    frame.precision(this->precision_);
+    frame << "<Grid Name=\"frame_" << this->current_step << "\" GridType=\"Uniform\">\n"
+          << "<Time Value=\"" << corrected_time << "\"/>\n"
+          << mesh_xml_;
+
+    // node and corner data (on discontinuous mesh nodes are corners of elements)
+    this->write_attributes(frame, output_data_vec_[NODE_DATA], "Node");
+    this->write_attributes(frame, output_data_vec_[CORNER_DATA], "Node");
+    this->write_attributes(frame, output_data_vec_[ELEM_DATA], "Cell");
+    // native data are not supported, they are used only for reading of VTK files
+    if ( !native_data_warned_ ) {
+        std::string native_fields;
+        for (OutputDataPtr data : output_data_vec_[NATIVE_DATA])
+            if ( !data->is_dummy() ) native_fields += " '" + data->field_input_name() + "'";
+        if (native_fields.size() > 0) {
+            WarningOut().fmt("Native data of fields{} are not supported by the xdmf output format and are not written to '{}'.\n",
+                    native_fields, string(this->_base_filename));
+            native_data_warned_ = true;
+        }
+    }
+
+    frame << "</Grid>\n";
+    frames_xml_ << frame.str();
+
+    container_.flush();
+    this->write_xdmf_file();
+
+    LogOut() << "O.K.";
+
+    return 1;
+}
+
+
+void OutputXDMF::write_xdmf_file(void)
+{
+    try {
+        this->_base_filename.open_stream( this->_base_file );
+    } INPUT_CATCH(FilePath::ExcFileOpen, FilePath::EI_Address_String, input_record_)
+
+    this->_base_file << "<?xml version=\"1.0\" ?>\n"
+                     << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n"
+                     << "<Xdmf Version=\"3.0\">\n"
+                     << "<Domain>\n"
+                     << "<Grid Name=\"" << this->_base_filename.stem() << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n"
+                     << frames_xml_.str()
+                     << "</Grid>\n"
+                     << "</Domain>\n"
+                     << "</Xdmf>\n";
+    this->_base_file.close();
+}
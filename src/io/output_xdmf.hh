@@ -0,0 +1,149 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    output_xdmf.hh
+ * @brief   Output of time series to single binary container described by XDMF file.
+ */
+
+#ifndef OUTPUT_XDMF_HH_
+#define OUTPUT_XDMF_HH_
+
+#include <fstream>                      // for ofstream
+#include <memory>                       // for shared_ptr
+#include <sstream>                      // for ostringstream
+#include <string>                       // for string
+#include "output_time.hh"               // for OutputTime, OutputTime::OutputDataFieldVec
+#include "element_data_cache_base.hh"   // for ElementDataCacheBase::VTKValueType
+
+class TimeUnitConversion;
+namespace Input {
+	class Record;
+	namespace Type {
+		class Record;
+		class Selection;
+	}
+}
+
+
+/**
+ * \brief Output of time series to the single binary container.
+ *
+ * Mesh geometry and topology are written to the container only once (at the first time frame),
+ * data of every field and time frame are appended to the container as a new dataset (optionally
+ * compressed by zlib). The container is described by the XDMF file (.xdmf), that is rewritten after
+ * every time frame, so it is valid also for an interrupted simulation. Every time frame is a grid
+ * of the temporal collection, grids share geometry and topology datasets of the container.
+ *
+ * Files:
+ *  - <base>.xdmf: XML description of time frames, readable by ParaView (XDMF reader)
+ *  - <base>.bin: binary container, datasets are stored in little endian byte order
+ *
+ * The container can be read without ParaView by the Python module 'flowpy.xdmf_reader'.
+ * Format is serial, data of parallel computation are gathered on the zero process.
+ */
+class OutputXDMF : public OutputTime {
+
+public:
+	typedef OutputTime FactoryBaseType;
+
+    /// Constructor.
+    OutputXDMF();
+
+    /// Destructor, performs output of the last time frame.
+    ~OutputXDMF();
+
+    /// The definition of input record for xdmf file format
+    static const Input::Type::Record & get_input_type();
+
+    /// The definition of input record for selection of variant of file format
+    static const Input::Type::Selection & get_input_type_variant();
+
+    /**
+     * \brief Append data of the current time frame to the container and rewrite XDMF file.
+     */
+    int write_data(void) override;
+
+    /// Override @p OutputTime::init_from_input.
+    void init_from_input(const std::string &equation_name,
+                         const Input::Record &in_rec,
+                         const std::shared_ptr<TimeUnitConversion>& time_unit_conv) override;
+
+protected:
+
+    /// Variants of storing of datasets in the container.
+    typedef enum {
+    	VARIANT_BINARY = 0,
+    	VARIANT_BINARY_ZLIB = 1
+    } XDMFVariant;
+
+    /// Registrar of class to factory
+    static const int registrar;
+
+    /// Size of chunk of uncompressed data passed to zlib at once.
+    static const std::size_t chunk_size = 1024 * 1024;
+
+    /**
+     * Append @p n_bytes of @p data to the container as a new dataset.
+     *
+     * Return position of dataset in the container (used as 'Seek' attribute of XDMF data item).
+     */
+    uint64_t append_dataset(const char *data, std::size_t n_bytes);
+
+    /**
+     * Write geometry and topology of the output mesh to the container.
+     *
+     * Done only at the first time frame or if the output mesh is changed.
+     */
+    void write_mesh(void);
+
+    /**
+     * Form XDMF DataItem of dataset stored in the container.
+     *
+     * @param dims         Dimensions of dataset (e.g. "10 3")
+     * @param vtk_type     Type of values
+     * @param seek         Position of dataset in the container
+     */
+    std::string data_item(const std::string &dims, ElementDataCacheBase::VTKValueType vtk_type, uint64_t seek);
+
+    /// Append data of all fields of @p output_data_vec to the container and write their XDMF attributes to @p frame.
+    void write_attributes(std::ostream &frame, OutputDataFieldVec &output_data_vec, const std::string &center);
+
+    /// Rewrite XDMF file, contains all written time frames.
+    void write_xdmf_file(void);
+
+    /// Output format (binary or binary compressed)
+    XDMFVariant variant_type_;
+
+    /// Binary container of datasets
+    std::ofstream container_;
+
+    /// Size of the container (position of next dataset)
+    uint64_t container_size_;
+
+    /// Name of the container file relative to the XDMF file
+    std::string container_name_;
+
+    /// Nodes of output mesh written to the container, geometry is written again if nodes are changed
+    std::shared_ptr<ElementDataCache<double>> written_nodes_;
+
+    /// XDMF description of geometry and topology shared by all time frames
+    std::string mesh_xml_;
+
+    /// XDMF description of written time frames
+    std::ostringstream frames_xml_;
+
+    /// Warning about unsupported native data is printed only once
+    bool native_data_warned_;
+};
+
+#endif /* OUTPUT_XDMF_HH_ */
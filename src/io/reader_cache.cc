@@ -15,6 +15,8 @@
  * @brief   
  */
 
+#include <sstream>
+#include <typeinfo>
 #include "io/reader_cache.hh"
 #include "io/msh_basereader.hh"
 #include "io/msh_gmshreader.h"
@@ -23,6 +25,8 @@
 #include "mesh/mesh.h"
 #include "mesh/bc_mesh.hh"
 #include "input/accessors.hh"
+#include "system/sys_profiler.hh"
+#include "system/logger.hh"
 
 
 /***********************************************************************************************
@@ -128,3 +132,88 @@ std::shared_ptr<EquivalentMeshMap> ReaderCache::eqivalent_mesh_map(const FilePat
     return reader_data.target_mesh_element_map_;
 }
 
+
+template<typename T>
+typename ElementDataCache<T>::CacheData ReaderCache::get_element_data(const FilePath &file_path,
+        BaseMeshReader::MeshDataHeader header, unsigned int expected_n_entities,
+        unsigned int expected_n_components, unsigned int boundary_begin) {
+	START_TIMER("ReaderCache::get_element_data");
+	ReaderCache *cache = ReaderCache::instance();
+
+	std::stringstream key_stream;
+	key_stream << string(file_path) << "\n" << header.field_name << "\n" << expected_n_entities << " "
+			<< expected_n_components << " " << boundary_begin << " " << typeid(T).name();
+	std::string key = key_stream.str();
+
+	auto frame_it = cache->frame_table_.find(key);
+	if ( (frame_it != cache->frame_table_.end()) && (frame_it->second.time_ == header.time) ) {
+		cache->lru_list_.splice(cache->lru_list_.begin(), cache->lru_list_, frame_it->second.lru_it_);
+		cache->n_hits_++;
+		return std::static_pointer_cast< std::vector<T> >(frame_it->second.data_);
+	}
+
+	typename ElementDataCache<T>::CacheData data;
+	{
+		START_TIMER("ReaderCache::read_frame");
+		auto reader = ReaderCache::get_reader(file_path);
+		data = reader->template get_element_data<T>(header, expected_n_entities, expected_n_components, boundary_begin);
+		reader->release_element_data(header.field_name); // frame is held only by cache and fields
+	}
+	cache->n_misses_++;
+
+	if (frame_it == cache->frame_table_.end()) {
+		cache->lru_list_.push_front(key);
+		frame_it = cache->frame_table_.insert( std::make_pair(key, DataFrame()) ).first;
+	} else {
+		// replace previous time frame of the field
+		cache->cached_bytes_ -= frame_it->second.n_bytes_;
+		cache->lru_list_.splice(cache->lru_list_.begin(), cache->lru_list_, frame_it->second.lru_it_);
+	}
+	frame_it->second.time_ = header.time;
+	frame_it->second.data_ = data;
+	frame_it->second.n_bytes_ = data->size() * sizeof(T);
+	frame_it->second.lru_it_ = cache->lru_list_.begin();
+	cache->cached_bytes_ += frame_it->second.n_bytes_;
+
+	cache->release_frames(key);
+	return data;
+}
+
+
+void ReaderCache::release_frames(const std::string &keep_key) {
+	if (memory_limit_ == 0) return;
+
+	unsigned int n_released = 0;
+	auto lru_it = lru_list_.end();
+	while ( (cached_bytes_ > memory_limit_) && (lru_it != lru_list_.begin()) ) {
+		--lru_it;
+		if (*lru_it == keep_key) continue;
+		auto frame_it = frame_table_.find(*lru_it);
+		cached_bytes_ -= frame_it->second.n_bytes_;
+		frame_table_.erase(frame_it);
+		lru_it = lru_list_.erase(lru_it);
+		n_released++;
+	}
+	n_released_ += n_released;
+
+	if (n_released > 0)
+		LogOut().fmt("ReaderCache: {} bytes of data frames cached (limit {}), hits: {}, misses: {}, released frames: {}.\n",
+				cached_bytes_, memory_limit_, n_hits_, n_misses_, n_released_);
+}
+
+
+void ReaderCache::set_memory_limit(std::size_t n_bytes) {
+	ReaderCache::instance()->memory_limit_ = n_bytes;
+	ReaderCache::instance()->release_frames("");
+}
+
+
+// explicit instantiation of template methods
+#define READER_CACHE_GET_ELEMENT_DATA(TYPE) \
+template typename ElementDataCache<TYPE>::CacheData ReaderCache::get_element_data<TYPE>(const FilePath &file_path, \
+        BaseMeshReader::MeshDataHeader header, unsigned int expected_n_entities, \
+        unsigned int expected_n_components, unsigned int boundary_begin);
+
+READER_CACHE_GET_ELEMENT_DATA(int)
+READER_CACHE_GET_ELEMENT_DATA(unsigned int)
+READER_CACHE_GET_ELEMENT_DATA(double)
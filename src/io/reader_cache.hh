@@ -19,9 +19,11 @@
 #define READER_CACHE_HH_
 
 
+#include <list>                 // for list
 #include <map>                  // for map, map<>::value_compare
 #include <memory>               // for shared_ptr
 #include <string>               // for string
+#include "io/msh_basereader.hh" // for BaseMeshReader::MeshDataHeader
 #include "system/file_path.hh"  // for FilePath
 #include "system/index_types.hh" // for LongIdx
 
@@ -74,18 +76,62 @@ public:
     static std::shared_ptr<EquivalentMeshMap> identic_mesh_map(const FilePath &file_path,
                                                                           Mesh *computational_mesh);
 
+	/**
+	 * Returns data of field given by \p header read from the file \p file_path.
+	 *
+	 * Read data frames are shared by all fields reading the same data (file, field, time). Only one time frame
+	 * of the field is cached. If total size of cached frames exceeds the memory limit, least recently used
+	 * frames are released. Parameters are same as in BaseMeshReader::get_element_data.
+	 */
+    template<typename T>
+    static typename ElementDataCache<T>::CacheData get_element_data(const FilePath &file_path,
+            BaseMeshReader::MeshDataHeader header, unsigned int expected_n_entities,
+            unsigned int expected_n_components, unsigned int boundary_begin);
+
+	/// Set limit of total size of cached data frames in bytes, zero value means unlimited size.
+	static void set_memory_limit(std::size_t n_bytes);
+
 private:
+	/// Data frame of one field stored in cache.
+	struct DataFrame {
+		double time_;                              ///< Time of data frame
+		std::shared_ptr<void> data_;               ///< Shared data vector (ElementDataCache<T>::CacheData)
+		std::size_t n_bytes_;                      ///< Size of data vector in bytes
+		std::list<std::string>::iterator lru_it_;  ///< Position in list of recently used frames
+	};
+
+	typedef std::map< std::string, DataFrame > DataFrameTable;
+
 	/// Returns singleton instance
 	static ReaderCache * instance();
 
 	/// Constructor
-	ReaderCache() {};
+	ReaderCache()
+	: memory_limit_(0), cached_bytes_(0), n_hits_(0), n_misses_(0), n_released_(0) {};
 
 	/// Returns instance of given FilePath. If reader doesn't exist, creates new ReaderData object.
 	static ReaderTable::iterator get_reader_data(const FilePath &file_path);
 
+	/// Release least recently used data frames until cached data fits to memory limit. Frame \p keep_key is never released.
+	void release_frames(const std::string &keep_key);
+
 	/// Table of readers
 	ReaderTable reader_table_;
+
+	/// Table of cached data frames
+	DataFrameTable frame_table_;
+
+	/// Keys of cached data frames, most recently used frame is first
+	std::list<std::string> lru_list_;
+
+	/// Limit of total size of cached data frames (0 means unlimited)
+	std::size_t memory_limit_;
+
+	/// Total size of cached data frames
+	std::size_t cached_bytes_;
+
+	/// Statistics of cache: count of returned cached frames, read frames and released frames
+	unsigned int n_hits_, n_misses_, n_released_;
 };
 
 
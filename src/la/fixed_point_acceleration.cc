@@ -0,0 +1,163 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    fixed_point_acceleration.cc
+ * @brief   Aitken relaxation and Anderson acceleration of fixed point iterations.
+ */
+
+#include <armadillo>
+#include "la/fixed_point_acceleration.hh"
+#include "system/asserts.hh"
+#include "system/sys_profiler.hh"
+#include "system/system.hh"
+
+
+FixedPointAcceleration::FixedPointAcceleration(Type type, unsigned int depth, double relaxation)
+: type_(type), depth_(depth), relaxation_(relaxation), omega_(relaxation), n_it_(0), r_(nullptr)
+{
+	ASSERT_PERMANENT_GT(depth_, 0);
+}
+
+
+FixedPointAcceleration::~FixedPointAcceleration()
+{
+	clear();
+}
+
+
+Vec FixedPointAcceleration::duplicate(Vec v)
+{
+	Vec copy;
+	chkerr(VecDuplicate(v, &copy));
+	chkerr(VecCopy(v, copy));
+	return copy;
+}
+
+
+void FixedPointAcceleration::clear()
+{
+	for (Vec &v : x_) chkerr(VecDestroy(&v));
+	for (Vec &v : g_) chkerr(VecDestroy(&v));
+	x_.clear();
+	g_.clear();
+	if (r_ != nullptr) chkerr(VecDestroy(&r_));
+	r_ = nullptr;
+	for (Vec &v : delta_r_) chkerr(VecDestroy(&v));
+	delta_r_.clear();
+	for (auto &dg : delta_g_)
+		for (Vec &v : dg) chkerr(VecDestroy(&v));
+	delta_g_.clear();
+}
+
+
+void FixedPointAcceleration::start(const std::vector<VectorMPI *> &vecs)
+{
+	clear();
+	n_it_ = 0;
+	omega_ = relaxation_;
+	if (type_ == none) return;
+
+	ASSERT_PERMANENT_GT(vecs.size(), 0);
+	for (VectorMPI *vec : vecs) x_.push_back( duplicate(vec->petsc_vec()) );
+}
+
+
+void FixedPointAcceleration::accelerate(const std::vector<VectorMPI *> &vecs)
+{
+	if (type_ == none) return;
+	ASSERT_PERMANENT_EQ(vecs.size(), x_.size()).error("Method start() was not called or it was called with different vectors.\n");
+	START_TIMER("FixedPointAcceleration::accelerate");
+
+	// residual r_k = G(x_k) - x_k
+	Vec r = duplicate(vecs[0]->petsc_vec());
+	chkerr(VecAXPY(r, -1.0, x_[0]));
+
+	// coefficients of Anderson combination, empty for relaxed step
+	arma::vec gamma;
+
+	if (type_ == aitken) {
+		if (n_it_ > 0) {
+			Vec dr = duplicate(r);
+			chkerr(VecAXPY(dr, -1.0, r_));
+			double dr_dr, r_dr;
+			chkerr(VecDot(dr, dr, &dr_dr));
+			chkerr(VecDot(r_, dr, &r_dr));
+			if (dr_dr > 0.0) omega_ = -omega_ * r_dr / dr_dr;
+			chkerr(VecDestroy(&dr));
+		}
+	} else {
+		if (n_it_ > 0) {
+			Vec dr = duplicate(r);
+			chkerr(VecAXPY(dr, -1.0, r_));
+			delta_r_.push_back(dr);
+			std::vector<Vec> dg(vecs.size());
+			for (unsigned int i=0; i<vecs.size(); ++i) {
+				dg[i] = duplicate(vecs[i]->petsc_vec());
+				chkerr(VecAXPY(dg[i], -1.0, g_[i]));
+			}
+			delta_g_.push_back(dg);
+			if (delta_r_.size() > depth_) {
+				chkerr(VecDestroy(&delta_r_.front()));
+				delta_r_.pop_front();
+				for (Vec &v : delta_g_.front()) chkerr(VecDestroy(&v));
+				delta_g_.pop_front();
+			}
+		}
+
+		// keep G(x_k) for the next difference
+		if (g_.empty())
+			for (VectorMPI *vec : vecs) g_.push_back( duplicate(vec->petsc_vec()) );
+		else
+			for (unsigned int i=0; i<vecs.size(); ++i) chkerr(VecCopy(vecs[i]->petsc_vec(), g_[i]));
+
+		if (delta_r_.size() > 0) {
+			// least squares problem min |r - dR gamma| solved through (slightly regularized) normal equations
+			unsigned int m = delta_r_.size();
+			arma::mat mat(m, m);
+			arma::vec rhs(m);
+			for (unsigned int i=0; i<m; ++i) {
+				for (unsigned int j=0; j<=i; ++j) {
+					chkerr(VecDot(delta_r_[i], delta_r_[j], &mat(i,j)));
+					mat(j,i) = mat(i,j);
+				}
+				chkerr(VecDot(delta_r_[i], r, &rhs(i)));
+			}
+			mat.diag() += 1e-12 * arma::trace(mat) / m;
+			if (! arma::solve(gamma, mat, rhs, arma::solve_opts::no_approx)) gamma.reset();
+		}
+	}
+
+	if (gamma.n_elem > 0) {
+		// x_{k+1} = G(x_k) - dG gamma
+		arma::vec minus_gamma = -gamma;
+		std::vector<Vec> dg(gamma.n_elem);
+		for (unsigned int i=0; i<vecs.size(); ++i) {
+			for (unsigned int j=0; j<gamma.n_elem; ++j) dg[j] = delta_g_[j][i];
+			chkerr(VecMAXPY(vecs[i]->petsc_vec(), gamma.n_elem, minus_gamma.memptr(), &(dg[0])));
+		}
+	} else {
+		// x_{k+1} = x_k + omega r_k
+		double omega = (type_ == aitken) ? omega_ : relaxation_;
+		for (unsigned int i=0; i<vecs.size(); ++i)
+			chkerr(VecAXPBY(vecs[i]->petsc_vec(), 1.0-omega, omega, x_[i]));
+	}
+
+	for (unsigned int i=0; i<vecs.size(); ++i) {
+		vecs[i]->local_to_ghost_begin();
+		vecs[i]->local_to_ghost_end();
+		chkerr(VecCopy(vecs[i]->petsc_vec(), x_[i]));
+	}
+	if (r_ != nullptr) chkerr(VecDestroy(&r_));
+	r_ = r;
+	n_it_++;
+}
@@ -0,0 +1,104 @@
+/*!
+ *
+﻿ * Copyright (C) 2015 Technical University of Liberec.  All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License version 3 as published by the
+ * Free Software Foundation. (http://www.gnu.org/licenses/gpl-3.0.en.html)
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ *
+ * @file    fixed_point_acceleration.hh
+ * @brief   Aitken relaxation and Anderson acceleration of fixed point iterations.
+ */
+
+#ifndef LA_FIXED_POINT_ACCELERATION_HH_
+#define LA_FIXED_POINT_ACCELERATION_HH_
+
+#include <deque>
+#include <vector>
+#include "petscvec.h"          // for Vec, _p_Vec
+#include "la/vector_mpi.hh"
+
+
+/**
+ * @brief Acceleration of the fixed point iteration x_{k+1} = G(x_k).
+ *
+ * The iterated state may consist of several distributed vectors (e.g. the Schur complement solution
+ * and the full solution of the flow). The first vector defines the residual r_k = G(x_k) - x_k, all vectors
+ * are updated by the same linear combination, so a state given by an affine map of the first vector stays
+ * consistent.
+ *
+ * Usage:
+ * - call @p start with vectors holding the initial iterate x_0,
+ * - after every evaluation of G call @p accelerate, vectors holding G(x_k) are overwritten by x_{k+1}.
+ *
+ * Strategies:
+ * - none: x_{k+1} = G(x_k)
+ * - aitken: x_{k+1} = x_k + w_k r_k, with dynamic relaxation factor
+ *   w_k = -w_{k-1} (r_{k-1}, r_k - r_{k-1}) / |r_k - r_{k-1}|^2 and w_0 given by @p relaxation
+ * - anderson: x_{k+1} = G(x_k) - sum_j gamma_j (G(x_{j+1}) - G(x_j)), where gamma minimizes
+ *   |r_k - sum_j gamma_j (r_{j+1} - r_j)| over last @p depth differences.
+ */
+class FixedPointAcceleration {
+public:
+	/// Type of acceleration.
+	typedef enum {
+		none = 0,
+		aitken = 1,
+		anderson = 2
+	} Type;
+
+	/**
+	 * Constructor.
+	 * @param type       Acceleration strategy.
+	 * @param depth      Number of kept differences of iterates (Anderson only).
+	 * @param relaxation Relaxation factor of the first iteration (and initial factor of Aitken).
+	 */
+	FixedPointAcceleration(Type type = none, unsigned int depth = 5, double relaxation = 1.0);
+
+	/// Destructor, free PETSc vectors.
+	~FixedPointAcceleration();
+
+	/// Store initial iterate, drop history of previous iterations.
+	void start(const std::vector<VectorMPI *> &vecs);
+
+	/// Replace G(x_k) stored in @p vecs by the accelerated iterate x_{k+1}.
+	void accelerate(const std::vector<VectorMPI *> &vecs);
+
+	/// Return type of acceleration.
+	inline Type type() const
+	{ return type_; }
+
+	/// Return current relaxation factor (Aitken).
+	inline double relaxation() const
+	{ return omega_; }
+
+private:
+	/// Free all work vectors.
+	void clear();
+
+	/// Vec holding copy of given vector (created by VecDuplicate).
+	static Vec duplicate(Vec v);
+
+	Type type_;              ///< Acceleration strategy.
+	unsigned int depth_;     ///< Depth of Anderson history.
+	double relaxation_;      ///< Relaxation factor of the first iteration.
+	double omega_;           ///< Current Aitken relaxation factor.
+	unsigned int n_it_;      ///< Number of accelerated iterations since last start.
+
+	std::vector<Vec> x_;     ///< Last iterate x_k, one Vec per state vector.
+	std::vector<Vec> g_;     ///< Last value G(x_{k-1}) (Anderson).
+	Vec r_;                  ///< Last residual r_{k-1}.
+
+	/// Differences of residuals (Anderson), the newest at the back.
+	std::deque<Vec> delta_r_;
+	/// Differences of G values (Anderson), one deque item per history entry, one Vec per state vector.
+	std::deque< std::vector<Vec> > delta_g_;
+};
+
+
+#endif /* LA_FIXED_POINT_ACCELERATION_HH_ */
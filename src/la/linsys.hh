@@ -227,6 +227,13 @@ public:
      */
     virtual void set_tolerances(double  r_tol, double a_tol, double d_tol, unsigned int max_it) = 0;
 
+    /**
+     * Allow the following solves to use the preconditioner of the last solve even if the matrix has changed.
+     * Ignored by solvers without such support.
+     */
+    virtual void set_reuse_preconditioner(bool)
+    {}
+
     /**
      * Returns true if the system matrix has changed since the last solve.
      */
@@ -548,6 +555,12 @@ public:
        return r_tol_;
     };
 
+    /**
+     * Override relative tolerance of the following solves, e.g. for an inexact solve within an outer iteration.
+     */
+    void set_relative_accuracy(double r_tol)
+    { r_tol_ = r_tol; }
+
     /**
      * Returns information on absolute solver accuracy
      */
@@ -21,6 +21,7 @@
 #include "petscvec.h"
 #include "petscksp.h"
 #include "petscmat.h"
+#include <algorithm>
 #include "system/sys_profiler.hh"
 #include "system/system.hh"
 
@@ -54,6 +55,17 @@ const it::Record & LinSys_PETSC::get_input_type() {
                     "Maximum number of outer iterations of the linear solver.")
 		.declare_key("options", it::String(), it::Default("\"\""),  "This options is passed to PETSC to create a particular KSP (Krylov space method).\n"
                                                                     "If the string is left empty (by default), the internal default options is used.")
+        .declare_key("pc_reuse_steps", it::Integer(0), it::Default("0"),
+                    "Number of following solves with a changed matrix that reuse the preconditioner. "
+                    "The preconditioner is rebuilt after that number of solves, or earlier if the number of iterations "
+                    "exceeds 'pc_reuse_it_ratio' times the number of iterations of the solve that built it. "
+                    "The preconditioner is always reused if the matrix has not changed since the last solve.")
+        .declare_key("pc_reuse_it_ratio", it::Double(1.0), it::Default("2.0"),
+                    "Allowed growth of the number of iterations of solves with a reused preconditioner.")
+        .declare_key("coo_assembly", it::Bool(), it::Default("false"),
+                    "Repeated assemblies of the matrix store values directly to slots of the COO format "
+                    "given by the first assembly instead of inserting them by MatSetValues. "
+                    "Requires PETSc 3.17 or newer, otherwise it is ignored.")
 		.close();
 }
 
@@ -65,7 +77,20 @@ LinSys_PETSC::LinSys_PETSC( const Distribution * rows_ds, const std::string &par
         : LinSys( rows_ds ),
           params_(params),
           init_guess_nonzero(false),
-          matrix_(0)
+          matrix_(0),
+          system(NULL),
+          reuse_preconditioner_(false),
+          pc_reuse_steps_(0),
+          pc_reuse_it_ratio_(2.0),
+          n_pc_reused_(0),
+          pc_setup_its_(-1),
+          coo_assembly_(false),
+          coo_recording_(false),
+          coo_recorded_(false),
+          coo_ready_(false),
+          coo_cycle_(false),
+          coo_started_(false),
+          coo_pos_(0)
 {
     // create PETSC vectors:
     PetscErrorCode ierr;
@@ -82,7 +107,12 @@ LinSys_PETSC::LinSys_PETSC( const Distribution * rows_ds, const std::string &par
 }
 
 LinSys_PETSC::LinSys_PETSC( LinSys_PETSC &other )
-	: LinSys(other), params_(other.params_), v_rhs_(NULL), solution_precision_(other.solution_precision_)
+	: LinSys(other), params_(other.params_), v_rhs_(NULL), solution_precision_(other.solution_precision_),
+	  system(NULL), reuse_preconditioner_(other.reuse_preconditioner_),
+	  pc_reuse_steps_(other.pc_reuse_steps_), pc_reuse_it_ratio_(other.pc_reuse_it_ratio_),
+	  n_pc_reused_(0), pc_setup_its_(-1),
+	  coo_assembly_(false), coo_recording_(false), coo_recorded_(false), coo_ready_(false), coo_cycle_(false),
+	  coo_started_(false), coo_pos_(0)
 {
 	MatCopy(other.matrix_, matrix_, DIFFERENT_NONZERO_PATTERN);
 	VecCopy(other.rhs_, rhs_);
@@ -153,12 +183,73 @@ void LinSys_PETSC::start_insert_assembly()
     status_ = INSERT;
 }
 
+PetscErrorCode LinSys_PETSC::mat_zero_entries()
+{
+    matrix_changed_ = true;
+    constraints_.clear();
+
+#if PETSC_VERSION_GE(3,17,0)
+    if (coo_assembly_) {
+        if (coo_recorded_ && !coo_ready_) {
+            // values of the recorded assembly are not needed anymore, set the COO structure
+            chkerr(MatSetPreallocationCOO(matrix_, coo_rows_.size(), coo_rows_.data(), coo_cols_.data()));
+            if (symmetric_) MatSetOption(matrix_, MAT_SYMMETRIC, PETSC_TRUE);
+            coo_vals_.resize(coo_rows_.size());
+            // indices are kept for checks of the assembly sequence
+            coo_ready_ = true;
+            // nonzero structure has changed
+            pc_setup_its_ = -1;
+        }
+        if (coo_ready_) {
+            std::fill(coo_vals_.begin(), coo_vals_.end(), 0.0);
+            coo_pos_ = 0;
+            coo_cycle_ = coo_started_ = true;
+            return 0;
+        }
+        coo_rows_.clear();
+        coo_cols_.clear();
+        coo_recording_ = true;
+    }
+#endif
+
+	return MatZeroEntries(matrix_);
+}
+
 void LinSys_PETSC::mat_set_values( int nrow, int *rows, int ncol, int *cols, double *vals )
 {
     // here vals would need to be converted from double to PetscScalar if it was ever something else than double :-)
     switch (status_) {
         case INSERT:
         case ADD:
+            if (coo_cycle_) {
+                // entries must follow the recorded sequence, otherwise values are set by MatSetValues
+                bool same_sequence = (status_ == ADD) && (coo_pos_ + nrow*ncol <= coo_vals_.size());
+                for (int i=0, k=coo_pos_; i<nrow && same_sequence; i++)
+                    for (int j=0; j<ncol; j++, k++)
+                        if ( coo_rows_[k]!=rows[i] || coo_cols_[k]!=cols[j] ) {
+                            same_sequence = false;
+                            break;
+                        }
+                if (same_sequence) {
+                    for (int i=0; i<nrow*ncol; i++, coo_pos_++) coo_vals_[coo_pos_] = vals[i];
+                    break;
+                }
+                coo_fallback();
+            }
+            if (coo_recording_) {
+                if (status_ == ADD) {
+                    for (int i=0; i<nrow; i++)
+                        for (int j=0; j<ncol; j++) {
+                            coo_rows_.push_back(rows[i]);
+                            coo_cols_.push_back(cols[j]);
+                        }
+                } else {
+                    // inserted values can not be expressed by the sum of COO entries
+                    coo_recording_ = false;
+                    coo_rows_.clear();
+                    coo_cols_.clear();
+                }
+            }
             chkerr(MatSetValues(matrix_,nrow,rows,ncol,cols,vals,(InsertMode)status_));
             break;
         case ALLOCATE:
@@ -170,6 +261,22 @@ void LinSys_PETSC::mat_set_values( int nrow, int *rows, int ncol, int *cols, dou
     matrix_changed_ = true;
 }
 
+void LinSys_PETSC::coo_fallback()
+{
+    WarningOut() << "Sequence of matrix entries differs from the recorded COO assembly, it is recorded again.\n";
+    coo_cycle_ = coo_ready_ = coo_recorded_ = false;
+
+    // values of previous assemblies are stored in the matrix, pattern of the new sequence can differ
+    chkerr(MatZeroEntries(matrix_));
+    MatSetOption(matrix_, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE);
+    for (unsigned int k=0; k<coo_pos_; k++)
+        chkerr(MatSetValues(matrix_, 1, &coo_rows_[k], 1, &coo_cols_[k], &coo_vals_[k], ADD_VALUES));
+
+    coo_rows_.resize(coo_pos_);
+    coo_cols_.resize(coo_pos_);
+    coo_recording_ = true;
+}
+
 void LinSys_PETSC::rhs_set_values( int nrow, int *rows, double *vals )
 {
     PetscErrorCode ierr;
@@ -205,6 +312,22 @@ void LinSys_PETSC::preallocate_values(int nrow,int *rows,int ncol,int *cols)
     }
 }
 
+void LinSys_PETSC::preallocate_pattern(int nrow, const int *rows, int ncol, const int *cols)
+{
+	ASSERT_EQ(status_, ALLOCATE).error("Linear system has to be in ALLOCATE status.");
+
+    if (pattern_rows_.size() == 0) pattern_rows_.resize( rows_ds_->lsize() );
+    for (int i=0; i<nrow; i++) {
+        if (rows_ds_->is_local(rows[i])) {
+            std::vector<PetscInt> &row_cols = pattern_rows_[ rows[i] - rows_ds_->begin() ];
+            row_cols.insert(row_cols.end(), cols, cols+ncol);
+        } else {
+            // rows of other processes are counted in the communicated vectors
+            preallocate_values(1, const_cast<int *>(rows+i), ncol, const_cast<int *>(cols));
+        }
+    }
+}
+
 void LinSys_PETSC::preallocate_matrix()
 {
 	ASSERT_EQ(status_, ALLOCATE).error("Linear system has to be in ALLOCATE status.");
@@ -231,6 +354,20 @@ void LinSys_PETSC::preallocate_matrix()
         off_nz[i] = std::min( rows_ds_->size() - rows_ds_->lsize(), static_cast<uint>( off_array[i]+0.1 ) );
     }
 
+    // add exact counts of the symbolic preallocation
+    for ( unsigned int i=0; i<pattern_rows_.size(); i++ ) {
+        std::vector<PetscInt> &row_cols = pattern_rows_[i];
+        std::sort(row_cols.begin(), row_cols.end());
+        row_cols.erase( std::unique(row_cols.begin(), row_cols.end()), row_cols.end() );
+        PetscInt n_on = 0;
+        for (PetscInt col : row_cols)
+            if (rows_ds_->is_local(col)) n_on++;
+        on_nz[i]  = std::min( static_cast<PetscInt>(rows_ds_->lsize()), on_nz[i] + n_on );
+        off_nz[i] = std::min( static_cast<PetscInt>(rows_ds_->size() - rows_ds_->lsize()),
+                off_nz[i] + static_cast<PetscInt>(row_cols.size()) - n_on );
+    }
+    std::vector< std::vector<PetscInt> >().swap(pattern_rows_);
+
     VecRestoreArray(on_vec_,&on_array);
     VecRestoreArray(off_vec_,&off_array);
     VecDestroy(&on_vec_);
@@ -243,6 +380,11 @@ void LinSys_PETSC::preallocate_matrix()
     }
     ierr = MatCreateAIJ(PETSC_COMM_WORLD, rows_ds_->lsize(), rows_ds_->lsize(), PETSC_DETERMINE, PETSC_DETERMINE,
                            0, on_nz, 0, off_nz, &matrix_); CHKERRV( ierr );
+    // preconditioner of the kept KSP belongs to the destroyed matrix
+    matrix_changed_ = true;
+    pc_setup_its_ = -1;
+    // COO structure belongs to the destroyed matrix
+    coo_recording_ = coo_recorded_ = coo_ready_ = coo_cycle_ = coo_started_ = false;
 
     if (symmetric_) MatSetOption(matrix_, MAT_SYMMETRIC, PETSC_TRUE);
     MatSetOption(matrix_, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_TRUE);
@@ -272,19 +414,41 @@ void LinSys_PETSC::finish_assembly( MatAssemblyType assembly_type )
     	WarningOut() << "Finalizing linear system without setting values.\n";
         this->preallocate_matrix();
     }
+#if PETSC_VERSION_GE(3,17,0)
+    if (coo_started_ && assembly_type == MAT_FINAL_ASSEMBLY) {
+        // MatSetValuesCOO is collective, fall back on all processes if sequence differs on any of them
+        int local_fallback = !coo_cycle_, fallback;
+        MPI_Allreduce(&local_fallback, &fallback, 1, MPI_INT, MPI_LOR, comm_);
+        if (fallback && coo_cycle_) coo_fallback();
+        coo_started_ = false;
+    }
+    if (coo_cycle_ && assembly_type == MAT_FINAL_ASSEMBLY) {
+        // slots not reached by a shorter assembly sequence stay zero,
+        // MatSetValuesCOO includes communication and assembly of the matrix
+        chkerr(MatSetValuesCOO(matrix_, coo_vals_.data(), INSERT_VALUES));
+        coo_cycle_ = false;
+    }
+#endif
     ierr = MatAssemblyBegin(matrix_, assembly_type); CHKERRV( ierr ); 
     ierr = VecAssemblyBegin(rhs_); CHKERRV( ierr ); 
     ierr = MatAssemblyEnd(matrix_, assembly_type); CHKERRV( ierr ); 
     ierr = VecAssemblyEnd(rhs_); CHKERRV( ierr ); 
 
-    if (assembly_type == MAT_FINAL_ASSEMBLY) status_ = DONE;
+    if (assembly_type == MAT_FINAL_ASSEMBLY) {
+        status_ = DONE;
+        if (coo_recording_) {
+            coo_recording_ = false;
+            coo_recorded_ = true;
+        }
+    }
 
     //PetscViewerPushFormat(PETSC_VIEWER_STDOUT_SELF, PETSC_VIEWER_ASCII_INDEX);
     //MatView(matrix_, PETSC_VIEWER_STDOUT_SELF);
     //VecView(rhs_, PETSC_VIEWER_STDOUT_SELF);
     //this->view();
 
-    matrix_changed_ = true;
+    // matrix_changed_ is set by methods modifying the matrix, assembly of the rhs only
+    // keeps the preconditioner of the previous solve
     rhs_changed_ = true;
 }
 
@@ -339,6 +503,23 @@ void LinSys_PETSC::set_initial_guess_nonzero(bool set_nonzero)
 }
 
 
+void LinSys_PETSC::set_reuse_preconditioner(bool flag)
+{
+	reuse_preconditioner_ = flag;
+}
+
+
+void LinSys_PETSC::set_coo_assembly(bool flag)
+{
+#if PETSC_VERSION_GE(3,17,0)
+	coo_assembly_ = flag;
+#else
+	if (flag) WarningOut() << "Assembly through COO slots requires PETSc 3.17 or newer, it is switched off.\n";
+	coo_assembly_ = false;
+#endif
+}
+
+
 LinSys::SolveInfo LinSys_PETSC::solve()
 {
 
@@ -381,8 +562,14 @@ LinSys::SolveInfo LinSys_PETSC::solve()
     
     MatSetOption( matrix_, MAT_USE_INODES, PETSC_FALSE );
     
-    chkerr(KSPCreate( comm_, &system ));
+    // KSP is kept between solves, so the preconditioner can be reused:
+    // always if the matrix has not changed, on demand of the owner of the system,
+    // or for a limited number of solves with changed matrix
+    bool reuse_pc = (system != NULL) && (pc_setup_its_ >= 0)
+            && (! matrix_changed_ || reuse_preconditioner_ || n_pc_reused_ < pc_reuse_steps_);
+    if (system == NULL) chkerr(KSPCreate( comm_, &system ));
     chkerr(KSPSetOperators(system, matrix_, matrix_));
+    chkerr(KSPSetReusePreconditioner(system, reuse_pc ? PETSC_TRUE : PETSC_FALSE));
 
 
     // TODO take care of tolerances - shall we support both input file and command line petsc setting
@@ -411,7 +598,17 @@ LinSys::SolveInfo LinSys_PETSC::solve()
     // substitute by PETSc call for residual
     VecNorm(rhs_, NORM_2, &residual_norm_);
     
-    LogOut().fmt("convergence reason {}, number of iterations is {}\n", reason, nits);
+    LogOut().fmt("convergence reason {}, number of iterations is {}, reused preconditioner: {}\n", reason, nits, reuse_pc);
+
+    if (! reuse_pc) {
+        pc_setup_its_ = nits;
+        n_pc_reused_ = 0;
+    } else if (matrix_changed_) {
+        n_pc_reused_++;
+        // rebuild the preconditioner in the next solve if it has degraded
+        if (nits > pc_reuse_it_ratio_ * std::max(pc_setup_its_, 1)) n_pc_reused_ = pc_reuse_steps_;
+    }
+    matrix_changed_ = false;
 
     // get residual norm
     KSPGetResidualNorm(system, &solution_precision_);
@@ -419,8 +616,6 @@ LinSys::SolveInfo LinSys_PETSC::solve()
     // TODO: I do not understand this 
     //Profiler::instance()->set_timer_subframes("SOLVING MH SYSTEM", nits);
 
-    chkerr(KSPDestroy(&system));
-
     return LinSys::SolveInfo(static_cast<int>(reason), static_cast<int>(nits));
 
 }
@@ -464,6 +659,7 @@ void LinSys_PETSC::view(string text )
 LinSys_PETSC::~LinSys_PETSC( )
 {
     if (matrix_ != NULL) { chkerr(MatDestroy(&matrix_)); }
+    if (system != NULL) { chkerr(KSPDestroy(&system)); }
     chkerr(VecDestroy(&rhs_));
 
     if (residual_ != NULL) chkerr(VecDestroy(&residual_));
@@ -481,6 +677,9 @@ void LinSys_PETSC::set_from_input(const Input::Record in_rec)
     // otherwise keep settings provided in constructor of LinSys_PETSC.
     std::string user_params = in_rec.val<string>("options");
 	if (user_params != "") params_ = user_params;
+	pc_reuse_steps_ = in_rec.val<unsigned int>("pc_reuse_steps");
+	pc_reuse_it_ratio_ = in_rec.val<double>("pc_reuse_it_ratio");
+	set_coo_assembly( in_rec.val<bool>("coo_assembly") );
 }
 
 
@@ -88,12 +88,7 @@ public:
     	return VecCopy(rhs, rhs_);
     }
 
-    PetscErrorCode mat_zero_entries() override
-    {
-        matrix_changed_ = true;
-        constraints_.clear();
-    	return MatZeroEntries(matrix_);
-    }
+    PetscErrorCode mat_zero_entries() override;
 
     PetscErrorCode rhs_zero_entries() override
     {
@@ -113,6 +108,13 @@ public:
 
     void preallocate_values(int nrow,int *rows,int ncol,int *cols);
 
+    /**
+     * Symbolic preallocation: add couplings @p rows x @p cols to the exact nonzero pattern of the matrix.
+     * Can be called in ALLOCATE status instead of the assembly. Columns of owned rows are stored and counted
+     * exactly, rows of other processes are counted as in @p preallocate_values.
+     */
+    void preallocate_pattern(int nrow, const int *rows, int ncol, const int *cols);
+
     void preallocate_matrix();
 
     void finish_assembly() override;
@@ -123,6 +125,21 @@ public:
 
     void set_initial_guess_nonzero(bool set_nonzero = true);
 
+    /**
+     * Switch on assembly through precomputed slots of the COO format (MatSetValuesCOO).
+     *
+     * The first add assembly started by @p mat_zero_entries is performed by MatSetValues and the
+     * sequence of entries passed to @p mat_set_values is recorded. Following assemblies started by
+     * @p mat_zero_entries only store values to the slots given by the order of the calls and pass
+     * them to PETSc at once in @p finish_assembly. These assemblies should repeat the recorded
+     * sequence of entries or its beginning. Entries are checked against the recorded sequence, if they
+     * differ the assembly falls back to MatSetValues and the new sequence is recorded.
+     */
+    void set_coo_assembly(bool flag);
+
+    /// Use the preconditioner of the kept KSP in the following solves, see @p LinSys::set_reuse_preconditioner.
+    void set_reuse_preconditioner(bool flag) override;
+
     LinSys::SolveInfo solve() override;
 
     /**
@@ -167,6 +184,11 @@ private:
     };
 
 protected:
+    /**
+     * Stop storing values of the current assembly to COO slots. Values stored so far are added
+     * by MatSetValues and the sequence of entries is recorded again from their position.
+     */
+    void coo_fallback();
 
     std::string params_;		 //!< command-line-like options for the PETSc solver
 
@@ -180,12 +202,29 @@ protected:
 
     Vec     on_vec_;             //!< Vectors for counting non-zero entries in diagonal block.
     Vec     off_vec_;            //!< Vectors for counting non-zero entries in off-diagonal block.
+    std::vector< std::vector<PetscInt> > pattern_rows_; //!< Columns of local rows given by symbolic preallocation.
+
+    bool coo_assembly_;                  ///< Use assembly through COO slots, see @p set_coo_assembly.
+    bool coo_recording_;                 ///< Entries of the current assembly are recorded.
+    bool coo_recorded_;                  ///< Sequence of entries of a whole assembly is recorded.
+    bool coo_ready_;                     ///< COO structure of the matrix is set.
+    bool coo_cycle_;                     ///< Current assembly stores values to COO slots.
+    bool coo_started_;                   ///< Current assembly was started as COO cycle on all processes.
+    std::vector<PetscInt> coo_rows_;     ///< Recorded row indices of the COO entries.
+    std::vector<PetscInt> coo_cols_;     ///< Recorded column indices of the COO entries.
+    std::vector<PetscScalar> coo_vals_;  ///< Values of the COO entries.
+    unsigned int coo_pos_;               ///< Next free slot of @p coo_vals_.
 
 
     double  solution_precision_; // precision of KSP system solver
 
-    KSP                system;
+    KSP                system;       ///< Solver kept between solves, created in the first solve.
     KSPConvergedReason reason;
+    bool reuse_preconditioner_;      ///< Do not rebuild preconditioner of @p system in the next solve.
+    unsigned int pc_reuse_steps_;    ///< Number of solves with changed matrix that may reuse the preconditioner.
+    double pc_reuse_it_ratio_;       ///< Allowed growth of iterations with reused preconditioner.
+    unsigned int n_pc_reused_;       ///< Number of solves with changed matrix since the preconditioner was built.
+    int pc_setup_its_;               ///< Iterations of the solve that built the preconditioner, -1 if not built yet.
 
 
 };
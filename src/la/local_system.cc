@@ -233,8 +233,21 @@ void LocalSystem::compute_schur_complement(uint offset, LocalSystem& schur, bool
     arma::uword n = matrix.n_rows - 1;
     ASSERT_LT(offset, n)("Schur complement (offset) dimension mismatch.");
 
+    arma::mat invA(offset, offset);
+    compute_inverse_block(offset, invA);
+    compute_schur_complement(offset, invA, schur, negative);
+}
+
+void LocalSystem::compute_schur_complement(uint offset, const arma::mat &invA, LocalSystem& schur, bool negative) const
+{
+    // only for square matrix
+    ASSERT_EQ(matrix.n_rows, matrix.n_cols)("Cannot compute Schur complement for non-square matrix.");
+    arma::uword n = matrix.n_rows - 1;
+    ASSERT_LT(offset, n)("Schur complement (offset) dimension mismatch.");
+    ASSERT_EQ(invA.n_rows, offset)("Size of inverse block mismatch.");
+
     // B * invA
-    arma::mat BinvA = matrix.submat(offset, 0, n, offset-1) * matrix.submat(0, 0, offset-1, offset-1).i();
+    arma::mat BinvA = matrix.submat(offset, 0, n, offset-1) * invA;
     
     // Schur complement S = C - B * invA * Bt
     schur.matrix = matrix.submat(offset, offset, n, n) - BinvA * matrix.submat(0, offset, offset-1, n);
@@ -254,10 +267,30 @@ void LocalSystem::reconstruct_solution_schur(uint offset, const arma::vec &schur
     arma::uword n = matrix.n_rows - 1;
     ASSERT_LT(offset, n)("Schur complement (offset) dimension mismatch.");
 
+    arma::mat invA(offset, offset);
+    compute_inverse_block(offset, invA);
+    reconstruct_solution_schur(offset, invA, schur_solution, reconstructed_solution);
+}
+
+void LocalSystem::reconstruct_solution_schur(uint offset, const arma::mat &invA, const arma::vec &schur_solution,
+        arma::vec& reconstructed_solution) const
+{
+    // only for square matrix
+    ASSERT_EQ(matrix.n_rows, matrix.n_cols)("Cannot compute Schur complement for non-square matrix.");
+    arma::uword n = matrix.n_rows - 1;
+    ASSERT_LT(offset, n)("Schur complement (offset) dimension mismatch.");
+    ASSERT_EQ(invA.n_rows, offset)("Size of inverse block mismatch.");
+
     reconstructed_solution.set_size(offset);
-    // invA
-    arma::mat invA =  matrix.submat(0, 0, offset-1, offset-1).i();
     
     // x = invA*b - invA * Bt * schur_solution
     reconstructed_solution = invA * rhs.subvec(0,offset-1) - invA * matrix.submat(0, offset, offset-1, n) * schur_solution;
 }
+
+void LocalSystem::compute_inverse_block(uint offset, arma::mat &invA) const
+{
+    ASSERT_EQ(matrix.n_rows, matrix.n_cols)("Cannot compute inverse block of non-square matrix.");
+    ASSERT_LE(offset, matrix.n_rows)("Inverse block (offset) dimension mismatch.");
+
+    invA = matrix.submat(0, 0, offset-1, offset-1).i();
+}
@@ -170,6 +170,23 @@ public:
      * @p negative if true, the schur complement (including its rhs) is multiplied by -1.0
      */
     void compute_schur_complement(uint offset, LocalSystem& schur, bool negative=false) const;
+
+    /** @brief Computes Schur complement of the local system with given inverse of submatrix A.
+     * Submatrix A of the local system is not used, so it need not be assembled.
+     *
+     * @p offset index of the first row/column of submatrix C (size of A)
+     * @p invA inverse of submatrix A, e.g. kept from previous call of @p compute_inverse_block
+     * @p schur (output) LocalSystem with Schur complement
+     * @p negative if true, the schur complement (including its rhs) is multiplied by -1.0
+     */
+    void compute_schur_complement(uint offset, const arma::mat &invA, LocalSystem& schur, bool negative=false) const;
+
+    /** @brief Computes inverse of the submatrix A (rows and columns 0 .. offset-1).
+     *
+     * @p offset index of the first row/column of submatrix C (size of A)
+     * @p invA (output) inverse of A, must have size offset x offset
+     */
+    void compute_inverse_block(uint offset, arma::mat &invA) const;
     
     /** @brief Reconstructs the solution from the Schur complement solution: x = invA*b - invA * Bt * schur_solution
      * Applicable for square matrices.
@@ -180,6 +197,10 @@ public:
      */
     void reconstruct_solution_schur(uint offset, const arma::vec &schur_solution, arma::vec& reconstructed_solution) const;
 
+    /// Variant of @p reconstruct_solution_schur with given inverse of submatrix A.
+    void reconstruct_solution_schur(uint offset, const arma::mat &invA, const arma::vec &schur_solution,
+            arma::vec& reconstructed_solution) const;
+
     /// Due to petsc options: MatSetOption(matrix_, MAT_IGNORE_ZERO_ENTRIES, PETSC_TRUE)
     /// all zeros will be thrown away from the system.
     /// If we do not want some zero entries in the system matrix to be thrown away,
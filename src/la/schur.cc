@@ -58,7 +58,7 @@
  */
 
 SchurComplement::SchurComplement(Distribution *ds, IS ia, IS ib)
-: LinSys_PETSC(ds), IsA(ia), IsB(ib), state(created)
+: LinSys_PETSC(ds), IsA(ia), IsB(ib), state(created), compl_pattern_of_xA_(false)
 {
         // check index set
         ASSERT_PTR(IsA).error("Index set IsA is not defined.\n");
@@ -115,7 +115,9 @@ SchurComplement::SchurComplement(Distribution *ds, IS ia, IS ib)
 SchurComplement::SchurComplement(SchurComplement &other)
 : LinSys_PETSC(other),
   loc_size_A(other.loc_size_A), loc_size_B(other.loc_size_B), state(other.state),
-  Compl(other.Compl), ds_(other.ds_)
+  Compl(other.Compl), ds_(other.ds_),
+  a_block_starts_(other.a_block_starts_), a_block_pos_(other.a_block_pos_), a_block_vals_(other.a_block_vals_),
+  compl_pattern_of_xA_(other.compl_pattern_of_xA_)
 {
 	MatCopy(other.A, A, DIFFERENT_NONZERO_PATTERN);
 	MatCopy(other.IA, IA, DIFFERENT_NONZERO_PATTERN);
@@ -210,13 +212,9 @@ void SchurComplement::form_schur()
     // nevertheless Petsc does not allows fill ratio below 1. so we use 1.1 for the first
     // and 1.5 for the second multiplication
 
-    // TODO:
-    // In order to let PETSC allocate structure of the complement we can not perform MatGetSubMatrix
-    // and MatAXPY on the same complement matrix, since one operation change the matrix structure for the other.
-    //
-    // Probably no way to make this optimal using high level methods. We should have our own
-    // format for schur complement matrix, store local systems and perform elimination localy.
-    // Or even better assembly the complement directly. (not compatible with raw P0 method)
+    // The structure is computed only in the first call (symbolic phase): blocks of A and the IA matrix,
+    // symbolic products IAB and xA (kept by PETSc with MAT_REUSE_MATRIX as long as IA, B, Bt are the same
+    // objects) and the nonzero pattern of the complement. Following calls only update values (numeric phase).
 
     if (matrix_changed_) {
        	create_inversion_matrix();
@@ -231,16 +229,38 @@ void SchurComplement::form_schur()
 		// get C block, loc_size_B removed
 		ierr+=MatGetSubMatrix( matrix_, IsB, IsB, mat_reuse, &C);
 
-		if (state==created) MatDuplicate(C, MAT_DO_NOT_COPY_VALUES, const_cast<Mat *>( Compl->get_matrix() ) );
-		MatZeroEntries( *( Compl->get_matrix()) );
-
-		// compute complement = (-1)cA+xA = Bt*IA*B - C
-		if ( is_negative_definite() ) {
-		    ierr+=MatAXPY(*( Compl->get_matrix() ), 1, C, SUBSET_NONZERO_PATTERN);
-			ierr+=MatAXPY(*( Compl->get_matrix() ), -1, xA, mat_subset_pattern);
+		Mat *compl_mat = const_cast<Mat *>( Compl->get_matrix() );
+		if (compl_pattern_of_xA_) {
+			// complement = xA - C (or C - xA), copy of values without any change of the pattern
+			ierr+=MatCopy(xA, *compl_mat, SAME_NONZERO_PATTERN);
+			if ( is_negative_definite() ) {
+				ierr+=MatScale(*compl_mat, -1.0);
+				ierr+=MatAXPY(*compl_mat, 1, C, SUBSET_NONZERO_PATTERN);
+			} else {
+				ierr+=MatAXPY(*compl_mat, -1, C, SUBSET_NONZERO_PATTERN);
+			}
 		} else {
-			ierr+=MatAXPY(*( Compl->get_matrix() ), -1, C, SUBSET_NONZERO_PATTERN);
-			ierr+=MatAXPY(*( Compl->get_matrix() ), 1, xA, mat_subset_pattern);
+			if (state==created) MatDuplicate(C, MAT_DO_NOT_COPY_VALUES, compl_mat );
+			MatZeroEntries( *compl_mat );
+
+			// compute complement = (-1)cA+xA = Bt*IA*B - C
+			if ( is_negative_definite() ) {
+				ierr+=MatAXPY(*compl_mat, 1, C, SUBSET_NONZERO_PATTERN);
+				ierr+=MatAXPY(*compl_mat, -1, xA, mat_subset_pattern);
+			} else {
+				ierr+=MatAXPY(*compl_mat, -1, C, SUBSET_NONZERO_PATTERN);
+				ierr+=MatAXPY(*compl_mat, 1, xA, mat_subset_pattern);
+			}
+
+			if (state==created) {
+				// complement pattern is union of patterns of C and xA, check if it is equal to the pattern of xA
+				MatInfo compl_info, xa_info;
+				ierr+=MatGetInfo(*compl_mat, MAT_LOCAL, &compl_info);
+				ierr+=MatGetInfo(xA, MAT_LOCAL, &xa_info);
+				int same_pattern = (compl_info.nz_used == xa_info.nz_used);
+				MPI_Allreduce(MPI_IN_PLACE, &same_pattern, 1, MPI_INT, MPI_MIN, PETSC_COMM_WORLD);
+				compl_pattern_of_xA_ = same_pattern;
+			}
 		}
 		Compl->set_matrix_changed();
 
@@ -298,34 +318,21 @@ Distribution *SchurComplement::make_complement_distribution()
 	return ds_;
 }
 
-void SchurComplement::create_inversion_matrix()
+void SchurComplement::create_inversion_structure()
 {
-    START_TIMER("create inversion matrix");
-    PetscInt ncols, pos_start, pos_start_IA;
-
-    MatReuse mat_reuse=MAT_REUSE_MATRIX;
-    if (state==created) mat_reuse=MAT_INITIAL_MATRIX; // indicate first construction
-
-    MatGetSubMatrix(matrix_, IsA, IsA, mat_reuse, &A);
-    MatDuplicate(A, MAT_DO_NOT_COPY_VALUES, &IA);
-    //MatGetSubMatrix(matrix_, IsA, IsA, mat_reuse, &IA);
-
-    MatGetOwnershipRange(A,&pos_start,PETSC_NULL);
-    MatGetOwnershipRange(IA,&pos_start_IA,PETSC_NULL);
-
-    std::vector<PetscInt> submat_rows;
+    START_TIMER("create inversion structure");
+    PetscInt ncols, pos_start;
     const PetscInt *cols;
-    const PetscScalar *vals;
-
-    std::vector<unsigned int> processed_rows(loc_size_A,0);
 
-    unsigned int mat_block=1;   //actual processed block of matrix
-    for(unsigned int loc_row=0; loc_row < processed_rows.size(); loc_row++) {
-        if (processed_rows[loc_row] != 0) continue;
+    MatGetOwnershipRange(A,&pos_start,PETSC_NULL);
 
+    a_block_starts_.clear();
+    a_block_pos_.clear();
+    unsigned int n_block_vals = 0;
+    PetscInt loc_row = 0;
+    while (loc_row < loc_size_A) {
         PetscInt min=std::numeric_limits<int>::max(), max=-1, size_submat;
         PetscInt b_vals = 0; // count of values stored in B-block of Orig system
-        submat_rows.clear();
         MatGetRow(A, loc_row + pos_start, &ncols, &cols, PETSC_NULL);
         for (PetscInt i=0; i<ncols; i++) {
             if (cols[i] < pos_start || cols[i] >= pos_start+loc_size_A) {
@@ -339,39 +346,79 @@ void SchurComplement::create_inversion_matrix()
                 }
             }
         }
+        MatRestoreRow(A, loc_row + pos_start, &ncols, &cols, PETSC_NULL);
         size_submat = max - min + 1;
         ASSERT(ncols-b_vals == size_submat).error("Submatrix cannot contains empty values.\n");
+        ASSERT(min == loc_row + pos_start).error("Block of A must start on its diagonal.\n");
 
-        MatRestoreRow(A, loc_row + pos_start, &ncols, &cols, PETSC_NULL);
-        arma::mat submat2(size_submat, size_submat);
-        submat2.zeros();
+        a_block_starts_.push_back(loc_row);
+        a_block_pos_.push_back(n_block_vals);
+        n_block_vals += size_submat * size_submat;
+        loc_row += size_submat;
+    }
+    a_block_starts_.push_back(loc_size_A);
+    a_block_vals_.resize(n_block_vals);
+
+    MatDuplicate(A, MAT_DO_NOT_COPY_VALUES, &IA);
+}
+
+
+void SchurComplement::create_inversion_matrix()
+{
+    START_TIMER("create inversion matrix");
+    PetscInt ncols, pos_start, pos_start_IA;
+    const PetscInt *cols;
+    const PetscScalar *vals;
+
+    MatReuse mat_reuse=MAT_REUSE_MATRIX;
+    if (state==created) mat_reuse=MAT_INITIAL_MATRIX; // indicate first construction
+
+    MatGetSubMatrix(matrix_, IsA, IsA, mat_reuse, &A);
+    if (state==created) create_inversion_structure();
+
+    MatGetOwnershipRange(A,&pos_start,PETSC_NULL);
+    MatGetOwnershipRange(IA,&pos_start_IA,PETSC_NULL);
+
+    // copy values of diagonal blocks to the contiguous storage, blocks are stored row by row
+    std::fill(a_block_vals_.begin(), a_block_vals_.end(), 0.0);
+    unsigned int n_blocks = a_block_pos_.size();
+    for (unsigned int i_block=0; i_block < n_blocks; i_block++) {
+        PetscInt block_start = a_block_starts_[i_block] + pos_start;
+        PetscInt size_submat = a_block_starts_[i_block+1] - a_block_starts_[i_block];
+        PetscScalar *block_vals = &a_block_vals_[ a_block_pos_[i_block] ];
         for (PetscInt i=0; i<size_submat; i++) {
-            processed_rows[ loc_row + i ] = mat_block;
-            submat_rows.push_back( i + loc_row + pos_start_IA );
-            MatGetRow(A, i + loc_row + pos_start, &ncols, &cols, &vals);
+            MatGetRow(A, i + block_start, &ncols, &cols, &vals);
             for (PetscInt j=0; j<ncols; j++) {
-                if (cols[j] >= pos_start && cols[j] < pos_start+loc_size_A) {
-                    submat2( i, cols[j] - loc_row - pos_start ) = vals[j];
+                if (cols[j] >= block_start && cols[j] < block_start+size_submat) {
+                    block_vals[ i*size_submat + cols[j] - block_start ] = vals[j];
                 }
             }
-            MatRestoreRow(A, i + loc_row + pos_start, &ncols, &cols, &vals);
-		}
-        // get inversion matrix
-        arma::mat invmat = submat2.i();
-        // stored to inversion IA matrix
-        const PetscInt* rows = &submat_rows[0];
-        MatSetValues(IA, submat_rows.size(), rows, submat_rows.size(), rows, invmat.memptr(), INSERT_VALUES);
+            MatRestoreRow(A, i + block_start, &ncols, &cols, &vals);
+        }
+    }
 
-        mat_block++;
+    // invert blocks in place; the column major view of a row major block is its transpose
+    // and inverse of transpose is transpose of inverse, so the result is row major again
+    for (unsigned int i_block=0; i_block < n_blocks; i_block++) {
+        PetscInt size_submat = a_block_starts_[i_block+1] - a_block_starts_[i_block];
+        arma::mat submat(&a_block_vals_[ a_block_pos_[i_block] ], size_submat, size_submat, false, true);
+        bool inverted = arma::inv(submat, submat);
+        ASSERT(inverted).error("Singular block of the A matrix.\n");
+    }
+
+    // stored to inversion IA matrix
+    std::vector<PetscInt> submat_rows;
+    for (unsigned int i_block=0; i_block < n_blocks; i_block++) {
+        PetscInt size_submat = a_block_starts_[i_block+1] - a_block_starts_[i_block];
+        submat_rows.resize(size_submat);
+        for (PetscInt i=0; i<size_submat; i++)
+            submat_rows[i] = i + a_block_starts_[i_block] + pos_start_IA;
+        const PetscInt* rows = &submat_rows[0];
+        MatSetValues(IA, size_submat, rows, size_submat, rows, &a_block_vals_[ a_block_pos_[i_block] ], INSERT_VALUES);
     }
 
     MatAssemblyBegin(IA, MAT_FINAL_ASSEMBLY);
     MatAssemblyEnd(IA, MAT_FINAL_ASSEMBLY);
-
-
-    /*
-    MatCreateMPIAIJSumSeqAIJ(PETSC_COMM_WORLD, locIA, PETSC_DECIDE, PETSC_DECIDE, reuse, &IA);
-    */
 }
 
 
@@ -20,6 +20,7 @@
 #define LA_SCHUR_HH_
 
 #include <petscmat.h>          // for Mat, _p_Mat
+#include <vector>              // for vector
 #include "la/linsys_PETSC.hh"  // for LinSys_PETSC
 #include "petscistypes.h"      // for IS, _p_IS
 #include "petscvec.h"          // for Vec, _p_Vec
@@ -141,6 +142,12 @@ protected:
     /// create IA matrix
     void create_inversion_matrix();
 
+    /**
+     * Find diagonal blocks of A, allocate their contiguous storage and create IA matrix.
+     * Called once, the structure is reused by all following calls of @p create_inversion_matrix.
+     */
+    void create_inversion_structure();
+
     void form_schur();
 
 
@@ -164,6 +171,11 @@ protected:
     LinSys_PETSC *Compl;        // Schur complement system: (C - B' IA B) * Sol2 = (B' * IA * RHS1 - RHS2)
 
     Distribution *ds_;          // Distribution of B block
+
+    std::vector<PetscInt> a_block_starts_;      ///< Local rows of A where diagonal blocks start, last item is loc_size_A.
+    std::vector<unsigned int> a_block_pos_;     ///< Positions of blocks in @p a_block_vals_.
+    std::vector<PetscScalar> a_block_vals_;     ///< Values of diagonal blocks of A (row major), inverted in place.
+    bool compl_pattern_of_xA_;  ///< Nonzero pattern of the complement is the pattern of xA (pattern of C is its subset).
 } SchurComplement;
 
 #endif /* LA_SCHUR_HH_ */
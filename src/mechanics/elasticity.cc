@@ -306,6 +306,7 @@ void Elasticity::EqData::create_dh(Mesh * mesh, unsigned int fe_order)
 
 Elasticity::Elasticity(Mesh & init_mesh, const Input::Record in_rec, TimeGovernor *tm)
         : EquationBase(init_mesh, in_rec),
+		  matrix_assembly_step_(-1),
 		  input_rec(in_rec),
 		  stiffness_assembly_(nullptr),
 		  rhs_assembly_(nullptr),
@@ -535,7 +536,10 @@ void Elasticity::preallocate()
 {
     // preallocate system matrix
 	eq_data_->ls->start_allocation();
-    stiffness_assembly_->assemble(eq_data_->dh_);
+    // pattern of the system matrix is given by connectivity of DOFs
+    stiffness_assembly_->assemble_pattern(eq_data_->dh_, [this](const std::vector<LongIdx> &dofs) {
+        ( (LinSys_PETSC *)eq_data_->ls )->preallocate_pattern(dofs.size(), dofs.data(), dofs.size(), dofs.data());
+    });
     rhs_assembly_->assemble(eq_data_->dh_);
 
     if (has_contact_)
@@ -575,14 +579,18 @@ void Elasticity::solve_linear_system()
     END_TIMER("data reinit");
     
     // assemble stiffness matrix
+    // Fields of the matrix are changed at most once per time step, so repeated solves
+    // within the step (iterations of HM coupling) keep the matrix and its preconditioner.
     if (eq_data_->ls->get_matrix() == NULL
-        || eq_fields_->subset(FieldFlag::in_main_matrix).changed())
+        || ( eq_fields_->subset(FieldFlag::in_main_matrix).changed()
+             && matrix_assembly_step_ != (int)time_->step().index() ))
     {
         DebugOut() << "Mechanics: Assembling matrix.\n";
         eq_data_->ls->start_add_assembly();
         eq_data_->ls->mat_zero_entries();
         stiffness_assembly_->assemble(eq_data_->dh_);
         eq_data_->ls->finish_assembly();
+        matrix_assembly_step_ = time_->step().index();
     }
 
     // assemble right hand side (due to sources and boundary conditions)
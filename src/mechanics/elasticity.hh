@@ -237,6 +237,9 @@ private:
     /// Indicator of contact conditions on fractures.
     bool has_contact_;
 
+    /// Index of the time step of the last assembly of the stiffness matrix.
+    int matrix_assembly_step_;
+
     
 	// @}
 
@@ -21,6 +21,7 @@
 #include "system/global_defs.h"
 #include <ctime>
 #include <stack>
+#include <numeric>
 
 /**
  * Minimum reduction of box size to allow
@@ -290,4 +291,44 @@ void BIHTree::find_point(const Space<3>::Point &point, std::vector<unsigned int>
 }
 
 
+void BIHTree::find_points(const std::vector<Space<3>::Point> &points, std::vector< std::vector<unsigned int> > &result_lists,
+        bool full_list) const
+{
+	result_lists.assign(points.size(), std::vector<unsigned int>());
+	if (points.size() == 0) return;
+	std::vector<BoundingBox> boxes;
+	boxes.reserve(points.size());
+	for (const auto &point : points) boxes.push_back(BoundingBox(point));
+
+	// nodes are processed in the same order as in find_bounding_box, every node with points that can intersect it
+	std::vector< std::pair< unsigned int, std::vector<unsigned int> > > point_stack;
+	point_stack.emplace_back( 0, std::vector<unsigned int>(points.size()) );
+	std::iota(point_stack.back().second.begin(), point_stack.back().second.end(), 0);
+	while (! point_stack.empty()) {
+		const BIHNode &node = nodes_[point_stack.back().first];
+		std::vector<unsigned int> node_points = std::move(point_stack.back().second);
+		point_stack.pop_back();
+
+		if (node.is_leaf()) {
+			for (unsigned int i_point : node_points)
+				for (unsigned int i=node.leaf_begin(); i<node.leaf_end(); i++) {
+					if (full_list || elements_[ in_leaves_[i] ].intersect(boxes[i_point])) {
+						result_lists[i_point].push_back(in_leaves_[i]);
+					}
+				}
+		} else {
+			std::vector<unsigned int> left_points, right_points;
+			for (unsigned int i_point : node_points) {
+				if ( ! boxes[i_point].projection_gt( node.axis(), nodes_[node.child(0)].bound() ) )
+					left_points.push_back(i_point);
+				if ( ! boxes[i_point].projection_lt( node.axis(), nodes_[node.child(1)].bound() ) )
+					right_points.push_back(i_point);
+			}
+			if (left_points.size() > 0) point_stack.emplace_back( node.child(0), std::move(left_points) );
+			if (right_points.size() > 0) point_stack.emplace_back( node.child(1), std::move(right_points) );
+		}
+	}
+}
+
+
 
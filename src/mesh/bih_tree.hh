@@ -91,6 +91,16 @@ public:
 	 */
     void find_point(const Space<3>::Point &point, std::vector<unsigned int> &result_list, bool full_list = false) const;
 
+	/**
+	 * Gets elements which can have intersection with each of given points, the tree is traversed once for all points.
+	 *
+	 * @param points Points which are tested if have intersection
+	 * @param result_lists vectors of ids of suspect elements, one vector for every point (in the same order as by @p find_point)
+	 * @param full_list same as in @p find_point
+	 */
+    void find_points(const std::vector<Space<3>::Point> &points, std::vector< std::vector<unsigned int> > &result_lists,
+            bool full_list = false) const;
+
     /**
      * Get vector of mesh elements bounding boxes
      *
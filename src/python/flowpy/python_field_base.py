@@ -138,6 +138,17 @@ class PythonFieldBase:
         self._result_fields_dict[field_name][..., self._region_chunk_begin:self._region_chunk_end] = res_array
 
 
+    @staticmethod
+    def _cache_update_batch(updates: List[Tuple['PythonFieldBase', str, int, int]]) -> None:
+        """
+        Method called from C++ code with all updates of the Python fields collected during
+        the update of a patch. Every item is the tuple (instance, field_name, reg_chunk_begin, reg_chunk_end),
+        the updates are evaluated in the given order.
+        """
+        for instance, field_name, reg_chunk_begin, reg_chunk_end in updates:
+            instance._cache_update(field_name, reg_chunk_begin, reg_chunk_end)
+
+
     def _print_fields(self):
         """ Auxiliary method for development """
         print("Dictionary contains fields: ")
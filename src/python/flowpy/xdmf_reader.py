@@ -0,0 +1,101 @@
+#!/bin/python3
+"""
+Reader of time series written by the 'xdmf' output format of Flow123d.
+
+The XDMF file (.xdmf) describes datasets stored in the single binary container (.bin).
+Geometry and topology are shared by all time frames, every field of every time frame
+is a separate dataset (raw or zlib compressed). Native data of fields are not written
+by the format (a warning is printed by Flow123d), only node, corner and element data.
+
+Usage:
+    reader = XdmfReader("output/flow.xdmf")
+    nodes = reader.geometry()                 # array of shape (n_nodes, 3)
+    elements = reader.elements()              # list of arrays of node indices
+    for i_frame, time in enumerate(reader.times):
+        pressure = reader.field("pressure_p0", i_frame)
+
+    python3 xdmf_reader.py output/flow.xdmf   # prints summary of the time series
+"""
+
+import os
+import sys
+import zlib
+import xml.etree.ElementTree as ET
+import numpy as np
+
+
+_dtypes = {
+    ("Char", 1): "<i1", ("UChar", 1): "<u1",
+    ("Int", 2): "<i2", ("UInt", 2): "<u2",
+    ("Int", 4): "<i4", ("UInt", 4): "<u4",
+    ("Float", 4): "<f4", ("Float", 8): "<f8",
+}
+
+# XDMF mixed topology codes: number of nodes of elements
+_n_element_nodes = {4: 3, 6: 4}
+_polyline = 2
+
+
+class XdmfReader:
+    def __init__(self, xdmf_file):
+        self.dir = os.path.dirname(os.path.abspath(xdmf_file))
+        root = ET.parse(xdmf_file).getroot()
+        self._frames = root.findall("./Domain/Grid/Grid")
+        self.times = [float(frame.find("Time").get("Value")) for frame in self._frames]
+
+    def _read_item(self, item):
+        """Read dataset described by DataItem element."""
+        dims = [int(d) for d in item.get("Dimensions").split()]
+        dtype = np.dtype(_dtypes[(item.get("NumberType"), int(item.get("Precision")))])
+        n_bytes = int(np.prod(dims)) * dtype.itemsize
+        with open(os.path.join(self.dir, item.text.strip()), "rb") as f:
+            f.seek(int(item.get("Seek", "0")))
+            if item.get("Compression", "Raw") == "Zlib":
+                decomp = zlib.decompressobj()
+                data = b""
+                while not decomp.eof:
+                    chunk = f.read(1024 * 1024)
+                    if not chunk:
+                        break
+                    data += decomp.decompress(chunk)
+            else:
+                data = f.read(n_bytes)
+        return np.frombuffer(data[:n_bytes], dtype=dtype).reshape(dims)
+
+    def geometry(self, i_frame=0):
+        """Coordinates of nodes, array of shape (n_nodes, 3)."""
+        return self._read_item(self._frames[i_frame].find("./Geometry/DataItem"))
+
+    def elements(self, i_frame=0):
+        """List of arrays of node indices of elements."""
+        topology = self._read_item(self._frames[i_frame].find("./Topology/DataItem"))
+        elements = []
+        i = 0
+        while i < len(topology):
+            code = topology[i]
+            if code == _polyline:
+                n_nodes = topology[i + 1]
+                i += 2
+            else:
+                n_nodes = _n_element_nodes[code]
+                i += 1
+            elements.append(topology[i:i + n_nodes])
+            i += n_nodes
+        return elements
+
+    def field_names(self, i_frame=0):
+        return [attr.get("Name") for attr in self._frames[i_frame].findall("Attribute")]
+
+    def field(self, name, i_frame):
+        """Values of field in given time frame, array of shape (n_values,) or (n_values, n_comp)."""
+        for attr in self._frames[i_frame].findall("Attribute"):
+            if attr.get("Name") == name:
+                return self._read_item(attr.find("DataItem"))
+        raise KeyError("Field '{}' not found in frame {}.".format(name, i_frame))
+
+
+if __name__ == "__main__":
+    reader = XdmfReader(sys.argv[1])
+    print("nodes: {}, elements: {}".format(len(reader.geometry()), len(reader.elements())))
+    for i_frame, time in enumerate(reader.times):
+        print("time {}: {}".format(time, ", ".join(reader.field_names(i_frame))))
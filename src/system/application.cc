@@ -44,6 +44,7 @@
 #include "system/asserts.hh"                           // for ASSERT_PERMANENT, msg
 #include "system/logger.hh"                            // for Logger, operat...
 #include "system/system.hh"                            // for SystemInfo
+#include "io/reader_cache.hh"                          // for ReaderCache
 
 
 
@@ -272,6 +273,9 @@ it::Record & Application::get_input_type() {
     		"Simulation problem to be solved.")
     .declare_key("pause_after_run", it::Bool(), it::Default("false"),
     		"If true, the program will wait for key press before it terminates.")
+    .declare_key("input_data_memory_limit", it::Integer(0), it::Default("0"),
+    		"Limit of memory in MB used by cached time frames of input fields read from mesh data files (GMSH, VTK). "
+    		"Least recently used frames are released if the limit is exceeded. Zero value means no limit.")
 	.close();
 
     return type;
@@ -559,6 +563,8 @@ void Application::run() {
 
         // should flow123d wait for pressing "Enter", when simulation is completed
         sys_info.pause_after_run = i_rec.val<bool>("pause_after_run");
+        // limit of memory used by data frames of input fields
+        ReaderCache::set_memory_limit( (std::size_t)i_rec.val<int>("input_data_memory_limit") * 1024 * 1024 );
         // read record with problem configuration
         Input::AbstractRecord i_problem = i_rec.val<AbstractRecord>("problem");
 
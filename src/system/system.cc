@@ -26,6 +26,8 @@
 
 #include <fstream>
 #include <string>
+#include <thread>
+#include <algorithm>
 #include "mpi.h"
 
 #include "system/system.hh"
@@ -41,6 +43,25 @@
 SystemInfo sys_info;
 
 
+unsigned int n_local_threads(unsigned int n_items)
+{
+    static unsigned int max_threads = 0;
+    if (max_threads == 0) {
+        const char *env_threads = std::getenv("FLOW123D_NUM_THREADS");
+        if (env_threads != nullptr && std::atoi(env_threads) > 0) {
+            max_threads = std::atoi(env_threads);
+        } else {
+            // cores are shared by processes, processes on one node are at most all processes
+            int mpi_initialized, n_proc = 1;
+            MPI_Initialized(&mpi_initialized);
+            if (mpi_initialized) MPI_Comm_size(MPI_COMM_WORLD, &n_proc);
+            max_threads = std::max(1u, std::thread::hardware_concurrency() / n_proc);
+        }
+    }
+    return std::min( max_threads, std::max(n_items, 1u) );
+}
+
+
 /*
 void *operator new (std::size_t size, const my_new_t &) throw() {
     return xmalloc(size);
@@ -136,6 +136,16 @@ char * xstrtok(char*,const char* delim, int position = -1);
 int    xchomp( char * s );
 */
 
+/**
+ * Number of threads for parallel processing of @p n_items local items (compression of data blocks etc.).
+ *
+ * Cores of the computer are divided by the number of MPI processes, so that threads of processes
+ * running on the same node do not oversubscribe it. The limit can be set explicitly by the environment
+ * variable FLOW123D_NUM_THREADS. No MPI communication is performed, the function can be called
+ * on a single process.
+ */
+unsigned int n_local_threads(unsigned int n_items);
+
 /**
  * Wrapper to check return codes of C functions. In particular PETSC calls.
  */
@@ -386,7 +386,12 @@ void TransportDG<Model>::preallocate()
         mass_matrix[i] = NULL;
         VecZeroEntries(eq_data_->ret_vec[i]);
     }
-    stiffness_assembly_->assemble(eq_data_->dh_);
+    // pattern of the system matrix is given by connectivity of DOFs
+    stiffness_assembly_->assemble_pattern(eq_data_->dh_, [this](const std::vector<LongIdx> &dofs) {
+        for (unsigned int i=0; i<eq_data_->n_substances(); i++)
+            ( (LinSys_PETSC *)eq_data_->ls[i] )->preallocate_pattern(dofs.size(), dofs.data(), dofs.size(), dofs.data());
+    });
+    // mass assembly computes also balance and retardation values
     mass_assembly_->assemble(eq_data_->dh_);
     sources_assembly_->assemble(eq_data_->dh_);
     bdr_cond_assembly_->assemble(eq_data_->dh_);
@@ -413,9 +418,14 @@ void TransportDG<Model>::update_solution()
     eq_fields_->set_time(Model::time_->step(), LimitSide::left);
     END_TIMER("data reinit");
 
+    // matrix of the system is set only if some of its parts or the time step changed,
+    // otherwise the linear solver can keep its preconditioner
+    bool matrix_changed = Model::time_->is_changed_dt();
+
     // assemble mass matrix
     if (mass_matrix[0] == NULL || eq_fields_->subset(FieldFlag::in_time_term).changed() )
     {
+        matrix_changed = true;
         for (unsigned int i=0; i<eq_data_->n_substances(); i++)
         {
         	eq_data_->ls_dt[i]->start_add_assembly();
@@ -445,6 +455,7 @@ void TransportDG<Model>::update_solution()
             || eq_fields_->subset(FieldFlag::in_main_matrix).changed()
             || eq_fields_->flow_flux.changed())
     {
+        matrix_changed = true;
         // new fluxes can change the location of Neumann boundary,
         // thus stiffness matrix must be reassembled
         for (unsigned int i=0; i<eq_data_->n_substances(); i++)
@@ -505,16 +516,19 @@ void TransportDG<Model>::update_solution()
     START_TIMER("solve");
     for (unsigned int i=0; i<eq_data_->n_substances(); i++)
     {
-        MatConvert(stiffness_matrix[i], MATSAME, MAT_INITIAL_MATRIX, &m);
-        MatAXPY(m, 1./Model::time_->dt(), mass_matrix[i], SUBSET_NONZERO_PATTERN);
-        eq_data_->ls[i]->set_matrix(m, DIFFERENT_NONZERO_PATTERN);
+        if (matrix_changed)
+        {
+            MatConvert(stiffness_matrix[i], MATSAME, MAT_INITIAL_MATRIX, &m);
+            MatAXPY(m, 1./Model::time_->dt(), mass_matrix[i], SUBSET_NONZERO_PATTERN);
+            eq_data_->ls[i]->set_matrix(m, DIFFERENT_NONZERO_PATTERN);
+            chkerr(MatDestroy(&m));
+        }
         Vec w;
         VecDuplicate(rhs[i], &w);
         VecWAXPY(w, 1./Model::time_->dt(), mass_vec[i], rhs[i]);
         eq_data_->ls[i]->set_rhs(w);
 
         VecDestroy(&w);
-        chkerr(MatDestroy(&m));
 
         eq_data_->ls[i]->solve();
 
@@ -597,8 +611,18 @@ void TransportDG<Model>::calculate_cumulative_balance()
         {
             Model::balance_->calculate_cumulative(eq_data_->subst_idx_[sbi], eq_data_->ls[sbi]->get_solution());
 
-            // update source increment due to retardation
-            VecDot(eq_data_->ret_vec[sbi], eq_data_->ls[sbi]->get_solution(), &ret_sources[sbi]);
+            // update source increment due to retardation,
+            // balance sums the local parts over processes
+            const double *ret_array, *sol_array;
+            PetscInt lsize;
+            VecGetLocalSize(eq_data_->ret_vec[sbi], &lsize);
+            VecGetArrayRead(eq_data_->ret_vec[sbi], &ret_array);
+            VecGetArrayRead(eq_data_->ls[sbi]->get_solution(), &sol_array);
+            ret_sources[sbi] = 0;
+            for (PetscInt i=0; i<lsize; ++i)
+                ret_sources[sbi] += ret_array[i]*sol_array[i];
+            VecRestoreArrayRead(eq_data_->ls[sbi]->get_solution(), &sol_array);
+            VecRestoreArrayRead(eq_data_->ret_vec[sbi], &ret_array);
 
             Model::balance_->add_cumulative_source(eq_data_->subst_idx_[sbi], (ret_sources[sbi]-ret_sources_prev[sbi])/Model::time_->dt());
             ret_sources_prev[sbi] = ret_sources[sbi];
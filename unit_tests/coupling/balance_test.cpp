@@ -0,0 +1,138 @@
+/*
+ * balance_test.cpp
+ *
+ * Test of cumulative balance computed in parallel: source due to reactions is computed
+ * from masses before and after the reaction on every process (as in TransportOperatorSplitting)
+ * and the local parts are summed over processes.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <mesh_constructor.hh>
+#include <fstream>
+#include <sstream>
+
+#include "config.h"
+
+#include "coupling/balance.hh"
+#include "fem/fe_p.hh"
+#include "fem/dofhandler.hh"
+#include "fem/dh_cell_accessor.hh"
+#include "la/vector_mpi.hh"
+#include "mesh/mesh.h"
+#include "input/reader_to_storage.hh"
+#include "input/accessors.hh"
+#include "system/sys_profiler.hh"
+#include "tools/mixed.hh"
+#include "tools/time_governor.hh"
+#include "tools/unit_si.hh"
+
+
+const string balance_input = R"YAML(
+times: [0, 1]
+add_output_times: false
+cumulative: true
+format: txt
+)YAML";
+
+
+/**
+ * Compute balance with reaction that halves the concentration, return values of the line "ALL"
+ * of the last frame (read on process #0).
+ */
+std::vector<double> reaction_balance(Mesh *mesh, const std::string &file_prefix, const std::string &input_yaml)
+{
+    auto in_rec = Input::ReaderToStorage(input_yaml, const_cast<Input::Type::Record &>(Balance::get_input_type()),
+                                         Input::FileFormat::format_YAML).get_root_interface<Input::Record>();
+
+    MixedPtr<FE_P_disc> fe(0);
+    std::shared_ptr<DiscreteSpace> ds = std::make_shared<EqualOrderDiscreteSpace>(mesh, fe);
+    std::shared_ptr<DOFHandlerMultiDim> dh = std::make_shared<DOFHandlerMultiDim>(*mesh);
+    dh->distribute_dofs(ds);
+
+    {
+        TimeGovernor tg(0.0, 1.0);
+        Balance balance(file_prefix, mesh);
+        balance.init_from_input(in_rec, tg);
+        balance.units(UnitSI().kg());
+        unsigned int q = balance.add_quantity("A");
+        balance.allocate(dh->lsize(), 1);
+
+        // unit mass on every element
+        balance.start_mass_assembly(q);
+        balance.start_source_assembly(q);
+        balance.start_flux_assembly(q);
+        for (auto cell : dh->own_range())
+            balance.add_mass_values(q, cell, cell.get_loc_dof_indices(), {1.0}, 0.0);
+        balance.finish_mass_assembly(q);
+        balance.finish_source_assembly(q);
+        balance.finish_flux_assembly(q);
+
+        VectorMPI solution(dh->lsize());
+        for (unsigned int i=0; i<dh->lsize(); ++i) solution.set(i, 1.0);
+
+        balance.calculate_instant(q, solution.petsc_vec());
+        balance.output();
+
+        tg.next_time();
+
+        // the same sequence as in TransportOperatorSplitting::update_solution
+        std::vector<double> region_mass(mesh->region_db().bulk_size(), 0);
+        balance.calculate_mass(q, solution.petsc_vec(), region_mass);
+        double source = 0;
+        for (double m : region_mass) source -= m;
+
+        for (unsigned int i=0; i<dh->lsize(); ++i) solution.set(i, 0.5);
+
+        balance.calculate_mass(q, solution.petsc_vec(), region_mass);
+        for (double m : region_mass) source += m;
+        balance.add_cumulative_source(q, source);
+
+        balance.calculate_instant(q, solution.petsc_vec());
+        balance.output();
+    }
+
+    // read the last line of total values
+    std::vector<double> values;
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == 0) {
+        std::ifstream balance_file(file_prefix + "_balance.txt");
+        std::string line, last_all;
+        while (std::getline(balance_file, line))
+            if (line.find("\"ALL\"") != std::string::npos) last_all = line;
+
+        std::stringstream ss(last_all);
+        std::string item;
+        while (std::getline(ss, item, '\t'))
+            if (item.find('"') == std::string::npos) values.push_back(std::stod(item));
+    }
+    return values;
+}
+
+
+TEST(Balance, cumulative_reaction_source) {
+    Profiler::instance();
+    FilePath::set_io_dirs(".", UNIT_TESTS_SRC_DIR, "", ".");
+    Mesh *mesh = mesh_full_constructor("{ mesh_file=\"fem/small_mesh.msh\", optimize_mesh=false }");
+    double n_elements = mesh->n_elements();
+
+    for (std::string matrix_free : {"false", "true"}) {
+        std::vector<double> values = reaction_balance(mesh, "test_balance_" + matrix_free,
+                                                      balance_input + "matrix_free: " + matrix_free + "\n");
+
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (rank == 0) {
+            // time, flux, flux_in, flux_out, mass, source, source_in, source_out, flux_increment, source_increment, ...
+            ASSERT_LT(9, values.size());
+            EXPECT_DOUBLE_EQ(1.0, values[0]);
+            EXPECT_DOUBLE_EQ(0.5*n_elements, values[4]);
+            // mass removed by the reaction on all processes
+            EXPECT_DOUBLE_EQ(-0.5*n_elements, values[9]);
+        }
+    }
+
+    delete mesh;
+}
@@ -0,0 +1,143 @@
+/*
+ * fe_values_bench.cpp
+ *
+ * Benchmark of initialization of FEValues (tables of shape functions on the reference element)
+ * and of their reinitialization on an element for P0, P1, P2, RT0 and mixed finite elements.
+ *
+ * Timers:
+ * - init_new_fe:    FEValues of newly created finite elements, tables are computed
+ * - init_shared_fe: FEValues of existing finite element and quadrature, tables are shared
+ * - reinit:         shape functions on the element
+ * Results are stored in 'fe_values_bench_profiler.json'.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+
+#include <cmath>
+#include <functional>
+#include "system/sys_profiler.hh"
+#include "quadrature/quadrature_lib.hh"
+#include "fem/fe_p.hh"
+#include "fem/fe_rt.hh"
+#include "fem/fe_system.hh"
+#include "fem/fe_values.hh"
+#include "mesh/mesh.h"
+#include "mesh/accessors.hh"
+
+
+/// Number of repetitions of every measured operation.
+static const unsigned int n_repeats = 1000;
+
+/// Quadrature order used for all finite elements.
+static const unsigned int quad_order = 4;
+
+
+class FEValuesBench : public testing::Test {
+public:
+    FEValuesBench()
+    {
+        Profiler::instance();
+        Profiler::set_memory_monitoring(false, false);
+
+        // line, triangle and tetrahedron sharing nodes
+        mesh_.init_node_vector(4);
+        mesh_.add_node(0, arma::vec3("0 0 0"));
+        mesh_.add_node(1, arma::vec3("2 0 0"));
+        mesh_.add_node(2, arma::vec3("0 1 0"));
+        mesh_.add_node(3, arma::vec3("0.5 0.5 3"));
+        mesh_.init_element_vector(3);
+        mesh_.add_element(0, 1, 1, 0, {0, 1});
+        mesh_.add_element(1, 2, 1, 0, {0, 1, 2});
+        mesh_.add_element(2, 3, 1, 0, {0, 1, 2, 3});
+    }
+
+    ~FEValuesBench()
+    {
+        Profiler::uninitialize();
+    }
+
+    /// Measure initialization and reinit of FEValues for finite element created by @p make_fe.
+    template<unsigned int dim>
+    void bench_fe(std::function< std::shared_ptr<FiniteElement<dim>>() > make_fe)
+    {
+        QGauss q(dim, quad_order);
+        UpdateFlags flags = update_values | update_gradients | update_JxW_values;
+
+        {
+            START_TIMER("init_new_fe");
+            for (unsigned int i=0; i<n_repeats; i++) {
+                std::shared_ptr<FiniteElement<dim>> fe = make_fe();
+                FEValues<3> fe_values(q, *fe, flags);
+            }
+            END_TIMER("init_new_fe");
+        }
+
+        // tables are shared while some FEValues of the element exists
+        std::shared_ptr<FiniteElement<dim>> fe = make_fe();
+        FEValues<3> fe_values(q, *fe, flags);
+        {
+            START_TIMER("init_shared_fe");
+            for (unsigned int i=0; i<n_repeats; i++) {
+                FEValues<3> fe_values_shared(q, *fe, flags);
+            }
+            END_TIMER("init_shared_fe");
+        }
+
+        ElementAccessor<3> elm = mesh_.element_accessor(dim-1);
+        double sum = 0;
+        {
+            START_TIMER("reinit");
+            for (unsigned int i=0; i<n_repeats; i++) {
+                fe_values.reinit(elm);
+                sum += fe_values.shape_value_component(0, 0, 0);
+            }
+            END_TIMER("reinit");
+        }
+        EXPECT_TRUE( std::isfinite(sum) );
+    }
+
+    Mesh mesh_;
+};
+
+
+TEST_F(FEValuesBench, shape_tables) {
+    {
+        START_TIMER("P0");
+        bench_fe<1>([]() { return std::make_shared<FE_P_disc<1>>(0); });
+        bench_fe<2>([]() { return std::make_shared<FE_P_disc<2>>(0); });
+        bench_fe<3>([]() { return std::make_shared<FE_P_disc<3>>(0); });
+    }
+    {
+        START_TIMER("P1");
+        bench_fe<1>([]() { return std::make_shared<FE_P<1>>(1); });
+        bench_fe<2>([]() { return std::make_shared<FE_P<2>>(1); });
+        bench_fe<3>([]() { return std::make_shared<FE_P<3>>(1); });
+    }
+    {
+        START_TIMER("P2");
+        bench_fe<1>([]() { return std::make_shared<FE_P<1>>(2); });
+        bench_fe<2>([]() { return std::make_shared<FE_P<2>>(2); });
+        bench_fe<3>([]() { return std::make_shared<FE_P<3>>(2); });
+    }
+    {
+        START_TIMER("RT0");
+        bench_fe<1>([]() { return std::make_shared<FE_RT0<1>>(); });
+        bench_fe<2>([]() { return std::make_shared<FE_RT0<2>>(); });
+        bench_fe<3>([]() { return std::make_shared<FE_RT0<3>>(); });
+    }
+    {
+        START_TIMER("P1_vector");
+        bench_fe<3>([]() { return std::make_shared<FESystem<3>>(std::make_shared<FE_P<3>>(1), FEVector, 3); });
+    }
+    {
+        START_TIMER("RT0_P0_mixed");
+        bench_fe<3>([]() {
+            std::vector<std::shared_ptr<FiniteElement<3>>> fe_vec = { std::make_shared<FE_RT0<3>>(), std::make_shared<FE_P_disc<3>>(0) };
+            return std::make_shared<FESystem<3>>(fe_vec);
+        });
+    }
+
+    Profiler::instance()->output(MPI_COMM_WORLD, "fe_values_bench_profiler.json");
+}
@@ -0,0 +1,136 @@
+/*
+ * generated_mesh.hh
+ *
+ * Procedural generation of simplex meshes of the unit line, square and cube
+ * used by benchmarks, no external mesh files are needed.
+ */
+
+#ifndef GENERATED_MESH_HH_
+#define GENERATED_MESH_HH_
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "system/asserts.hh"
+
+
+/// Sizes of a generated mesh.
+struct GeneratedMeshInfo {
+    unsigned int dim;
+    unsigned int n_nodes;
+    unsigned int n_elements;
+    unsigned int n_faces;   ///< Number of (dim-1) dimensional faces (edges of the mesh).
+};
+
+
+/**
+ * Write GMSH (ASCII 2.2) mesh of the unit domain of dimension @p dim with @p n_subdiv subdivisions
+ * along every axis. Squares are split into 2 triangles, cubes into 6 tetrahedra (Kuhn subdivision),
+ * all elements belong to the region 'bulk'.
+ *
+ * The 'unstructured' variant perturbs the interior nodes by random shifts up to 10% of the step
+ * and randomly permutes numbering of nodes and elements, i.e. the mesh has no memory locality
+ * given by the structured grid.
+ */
+GeneratedMeshInfo generate_simplex_mesh(const std::string &file_name, unsigned int dim, unsigned int n_subdiv,
+        bool unstructured, unsigned int seed = 0)
+{
+    ASSERT_PERMANENT(dim >= 1 && dim <= 3)(dim);
+    ASSERT_PERMANENT_GT(n_subdiv, 0);
+
+    std::mt19937 gen(seed);
+    double h = 1.0 / n_subdiv;
+    unsigned int n_row = n_subdiv + 1;
+    unsigned int n_nodes = 1;
+    for (unsigned int d=0; d<dim; ++d) n_nodes *= n_row;
+
+    // nodes of the grid, index = i + j*n_row + k*n_row^2
+    std::vector< std::array<double, 3> > nodes(n_nodes, {{0.0, 0.0, 0.0}});
+    std::uniform_real_distribution<double> shift(-0.1*h, 0.1*h);
+    for (unsigned int idx=0; idx<n_nodes; ++idx) {
+        unsigned int rest = idx;
+        for (unsigned int d=0; d<dim; ++d) {
+            unsigned int i = rest % n_row;
+            rest /= n_row;
+            nodes[idx][d] = i * h;
+            if (unstructured && i > 0 && i < n_subdiv) nodes[idx][d] += shift(gen);
+        }
+    }
+
+    // elements, every cell of the grid is split into dim! simplices
+    std::vector< std::vector<unsigned int> > elements;
+    unsigned int n_cells = 1;
+    for (unsigned int d=0; d<dim; ++d) n_cells *= n_subdiv;
+    std::vector< std::array<unsigned int, 3> > perms;
+    if (dim == 1) perms = { {{0,0,0}} };
+    else if (dim == 2) perms = { {{0,1,0}}, {{1,0,0}} };
+    else perms = { {{0,1,2}}, {{0,2,1}}, {{1,0,2}}, {{1,2,0}}, {{2,0,1}}, {{2,1,0}} };
+    unsigned int stride[3] = { 1, n_row, n_row*n_row };
+    for (unsigned int cell=0; cell<n_cells; ++cell) {
+        unsigned int rest = cell, origin = 0;
+        for (unsigned int d=0; d<dim; ++d) {
+            origin += (rest % n_subdiv) * stride[d];
+            rest /= n_subdiv;
+        }
+        // simplex given by the path from the origin to the opposite vertex of the cell along axes in order perm
+        for (auto &perm : perms) {
+            std::vector<unsigned int> ele(1, origin);
+            unsigned int node = origin;
+            for (unsigned int d=0; d<dim; ++d) {
+                node += stride[ perm[d] ];
+                ele.push_back(node);
+            }
+            elements.push_back(ele);
+        }
+    }
+
+    // count faces
+    std::set< std::vector<unsigned int> > faces;
+    for (auto &ele : elements)
+        for (unsigned int i=0; i<=dim; ++i) {
+            std::vector<unsigned int> face;
+            for (unsigned int j=0; j<=dim; ++j)
+                if (j != i) face.push_back(ele[j]);
+            std::sort(face.begin(), face.end());
+            faces.insert(face);
+        }
+
+    // numbering of nodes and order of elements
+    std::vector<unsigned int> node_id(n_nodes);
+    std::iota(node_id.begin(), node_id.end(), 1);
+    if (unstructured) {
+        std::shuffle(node_id.begin(), node_id.end(), gen);
+        std::shuffle(elements.begin(), elements.end(), gen);
+    }
+
+    std::ofstream out(file_name);
+    ASSERT_PERMANENT(out.good())(file_name).error("Can not open mesh file.\n");
+    out.precision(17);
+    out << "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n";
+    out << "$PhysicalNames\n1\n" << dim << " 1 \"bulk\"\n$EndPhysicalNames\n";
+    out << "$Nodes\n" << n_nodes << "\n";
+    std::vector<unsigned int> node_order(n_nodes);
+    for (unsigned int idx=0; idx<n_nodes; ++idx) node_order[ node_id[idx]-1 ] = idx;
+    for (unsigned int idx : node_order)
+        out << node_id[idx] << " " << nodes[idx][0] << " " << nodes[idx][1] << " " << nodes[idx][2] << "\n";
+    out << "$EndNodes\n";
+    const unsigned int gmsh_type[4] = { 15, 1, 2, 4 };
+    out << "$Elements\n" << elements.size() << "\n";
+    for (unsigned int i=0; i<elements.size(); ++i) {
+        out << i+1 << " " << gmsh_type[dim] << " 2 1 1";
+        for (unsigned int node : elements[i]) out << " " << node_id[node];
+        out << "\n";
+    }
+    out << "$EndElements\n";
+
+    return { dim, n_nodes, (unsigned int)elements.size(), (unsigned int)faces.size() };
+}
+
+
+#endif /* GENERATED_MESH_HH_ */
@@ -0,0 +1,323 @@
+/*
+ * generated_problems_bench.cpp
+ *
+ * Benchmark of whole simulations (flow, FV and DG transport, HM coupling with mechanics)
+ * on procedurally generated meshes.
+ *
+ * Meshes are generated in the directory of the benchmark, size of meshes is multiplied
+ * by the environment variable BENCHMARK_MESH_SCALE (default 1).
+ * Results are written to 'generated_problems_bench.json', one item per run:
+ * - problem, dimension, mesh variant and sizes of the mesh
+ * - wall time of the simulation and throughput in elements/s and DOFs/s
+ *   (number of DOFs is estimated from the mesh and the discretization)
+ * - PETSc floating point operations (GFLOP/s)
+ * - peak resident memory of the process
+ * Timers of the runs are stored in 'generated_problems_profiler.json'.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <sys/resource.h>
+#include <boost/algorithm/string/replace.hpp>
+#include <nlohmann/json.hpp>
+#include <petsclog.h>
+
+#include "generated_mesh.hh"
+#include "coupling/hc_explicit_sequential.hh"
+#include "input/accessors.hh"
+#include "input/reader_to_storage.hh"
+#include "system/application.hh"
+#include "system/file_path.hh"
+#include "system/sys_profiler.hh"
+
+
+/// Input of the benchmarked problems, MESH_FILE is replaced by the path of the generated mesh.
+const std::string flow_input = R"YAML(
+flow123d_version: 4.0.0
+problem: !Coupling_Sequential
+  description: Benchmark of steady flow
+  mesh:
+    mesh_file: MESH_FILE
+  flow_equation: !Flow_Darcy_LMH
+    nonlinear_solver:
+      linear_solver: !Petsc
+        a_tol: 1.0e-12
+        r_tol: 1.0e-12
+    input_fields:
+      - region: BULK
+        conductivity: !FieldFormula
+          value: 1 + X[0]*X[1]
+      - region: .BOUNDARY
+        bc_type: dirichlet
+        bc_pressure: !FieldFormula
+          value: X[0]
+)YAML";
+
+const std::string transport_fv_input = R"YAML(
+flow123d_version: 4.0.0
+problem: !Coupling_Sequential
+  description: Benchmark of FV transport
+  mesh:
+    mesh_file: MESH_FILE
+  flow_equation: !Flow_Darcy_LMH
+    nonlinear_solver:
+      linear_solver: !Petsc
+        a_tol: 1.0e-12
+        r_tol: 1.0e-12
+    input_fields:
+      - region: BULK
+        conductivity: 1
+      - region: .BOUNDARY
+        bc_type: dirichlet
+        bc_pressure: !FieldFormula
+          value: X[0]
+  solute_equation: !Coupling_OperatorSplitting
+    transport: !Solute_Advection_FV
+      input_fields:
+        - region: BULK
+          init_conc: 0
+          porosity: !FieldFormula
+            value: 0.1 + 0.1*X[0]
+        - region: .BOUNDARY
+          bc_conc: 1
+    substances:
+      - A
+    time:
+      end_time: 0.1
+)YAML";
+
+const std::string transport_dg_input = R"YAML(
+flow123d_version: 4.0.0
+problem: !Coupling_Sequential
+  description: Benchmark of DG transport
+  mesh:
+    mesh_file: MESH_FILE
+  flow_equation: !Flow_Darcy_LMH
+    nonlinear_solver:
+      linear_solver: !Petsc
+        a_tol: 1.0e-12
+        r_tol: 1.0e-12
+    input_fields:
+      - region: BULK
+        conductivity: 1
+      - region: .BOUNDARY
+        bc_type: dirichlet
+        bc_pressure: !FieldFormula
+          value: X[0]
+  solute_equation: !Coupling_OperatorSplitting
+    transport: !Solute_AdvectionDiffusion_DG
+      input_fields:
+        - region: BULK
+          init_conc: 0
+          porosity: 0.1
+          diff_m: !FieldFormula
+            value: 1e-3*(1 + X[1])
+          disp_l: 0.01
+          disp_t: 0.01
+        - region: .BOUNDARY
+          bc_type: dirichlet
+          bc_conc: 1
+      solver: !Petsc
+        a_tol: 1.0e-12
+        r_tol: 1.0e-12
+    substances:
+      - A
+    time:
+      end_time: 1
+      min_dt: 0.1
+      max_dt: 0.1
+)YAML";
+
+const std::string hm_input = R"YAML(
+flow123d_version: 4.0.0
+problem: !Coupling_Sequential
+  description: Benchmark of HM coupling
+  mesh:
+    mesh_file: MESH_FILE
+  flow_equation: !Coupling_Iterative
+    input_fields:
+      - region: BULK
+        biot_alpha: 1
+        fluid_density: 1000
+    time:
+      end_time: 3
+      min_dt: 1
+      max_dt: 1
+    r_tol: 1e-8
+    flow_equation: !Flow_Darcy_LMH
+      gravity: [0,0,0]
+      nonlinear_solver:
+        linear_solver: !Petsc
+          a_tol: 0
+          r_tol: 1e-12
+      input_fields:
+        - region: BULK
+          conductivity: 1e-3
+          storativity: 1e-3
+          init_pressure: 0
+        - region: .BOUNDARY
+          bc_type: dirichlet
+          bc_pressure: !FieldFormula
+            value: X[0]
+    mechanics_equation:
+      output_stream:
+        file: mechanics.pvd
+        format: !vtk
+      solver: !Petsc
+        a_tol: 0
+        r_tol: 1e-12
+      input_fields:
+        - region: BULK
+          young_modulus: 1e4
+          poisson_ratio: 0.25
+        - region: .BOUNDARY
+          bc_type: displacement
+          bc_displacement: 0
+)YAML";
+
+
+/// Definition of a benchmarked problem.
+struct BenchProblem {
+    std::string name;
+    const std::string &input;
+    std::vector<unsigned int> dims;
+    /// Estimate of DOFs of the problem on given mesh.
+    std::function<double(const GeneratedMeshInfo &)> n_dofs;
+};
+
+
+/// Number of DOFs of the LMH flow: sides, elements and edges.
+double lmh_dofs(const GeneratedMeshInfo &m) {
+    return (m.dim+2) * m.n_elements + m.n_faces;
+}
+
+
+class GeneratedProblemsBench : public testing::Test {
+public:
+    GeneratedProblemsBench()
+    : root_dir_(string(UNIT_TESTS_BIN_DIR) + "/flow")
+    {
+        FilePath::set_io_dirs(".", root_dir_, "", "generated_problems_output");
+        Profiler::instance();
+        Profiler::set_memory_monitoring(false, false);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+
+        const char *scale = std::getenv("BENCHMARK_MESH_SCALE");
+        mesh_scale_ = (scale == nullptr) ? 1 : std::max(1, std::atoi(scale));
+    }
+
+    /// Generate mesh on rank 0, return its sizes on all ranks.
+    GeneratedMeshInfo make_mesh(const std::string &file_name, unsigned int dim, bool unstructured) {
+        // base subdivisions give meshes with about 20 - 25 thousands of elements,
+        // number of elements is multiplied by the scale
+        const unsigned int base_subdiv[4] = { 0, 20000, 100, 16 };
+        unsigned int n_subdiv = std::lround( base_subdiv[dim] * std::pow(mesh_scale_, 1.0/dim) );
+
+        GeneratedMeshInfo info;
+        if (rank_ == 0) info = generate_simplex_mesh(root_dir_ + "/" + file_name, dim, n_subdiv, unstructured, 1);
+        MPI_Bcast(&info, sizeof(GeneratedMeshInfo), MPI_BYTE, 0, MPI_COMM_WORLD);
+        return info;
+    }
+
+    /// Run the problem, return item of the JSON report.
+    nlohmann::json run_problem(const BenchProblem &problem, const std::string &mesh_file, const GeneratedMeshInfo &mesh) {
+        std::string input = boost::replace_all_copy(problem.input, "MESH_FILE", mesh_file);
+        Input::ReaderToStorage reader( input, Application::get_input_type(), Input::FileFormat::format_YAML );
+        Input::Record root_rec = reader.get_root_interface<Input::Record>();
+
+        PetscLogDouble flops_begin, flops_end;
+        PetscGetFlops(&flops_begin);
+        auto time_begin = std::chrono::steady_clock::now();
+        {
+            HC_ExplicitSequential hc( root_rec.val<Input::AbstractRecord>("problem") );
+            hc.run_simulation();
+        }
+        auto time_end = std::chrono::steady_clock::now();
+        PetscGetFlops(&flops_end);
+
+        double time = std::chrono::duration<double>(time_end - time_begin).count();
+        double flops = flops_end - flops_begin;
+        MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+        MPI_Allreduce(MPI_IN_PLACE, &flops, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        double peak_rss = usage.ru_maxrss * 1024.0; // kB on Linux
+        MPI_Allreduce(MPI_IN_PLACE, &peak_rss, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+        double n_dofs = problem.n_dofs(mesh);
+        int n_proc;
+        MPI_Comm_size(MPI_COMM_WORLD, &n_proc);
+        return {
+            {"problem", problem.name},
+            {"mesh", mesh_file},
+            {"dim", mesh.dim},
+            {"n_proc", n_proc},
+            {"n_nodes", mesh.n_nodes},
+            {"n_elements", mesh.n_elements},
+            {"n_dofs", n_dofs},
+            {"time", time},
+            {"elements_per_s", mesh.n_elements / time},
+            {"dofs_per_s", n_dofs / time},
+            {"petsc_gflops_per_s", flops / time * 1e-9},
+            {"peak_rss_bytes", peak_rss}
+        };
+    }
+
+    std::string root_dir_;
+    int rank_;
+    int mesh_scale_;
+};
+
+
+TEST_F(GeneratedProblemsBench, simulations) {
+    std::vector<BenchProblem> problems = {
+        { "flow_lmh", flow_input, {1, 2, 3}, lmh_dofs },
+        { "transport_fv", transport_fv_input, {1, 2, 3},
+                [](const GeneratedMeshInfo &m) { return lmh_dofs(m) + m.n_elements; } },
+        { "transport_dg", transport_dg_input, {1, 2, 3},
+                [](const GeneratedMeshInfo &m) { return lmh_dofs(m) + (m.dim+1) * m.n_elements; } },
+        { "hm_mechanics", hm_input, {2, 3},
+                [](const GeneratedMeshInfo &m) { return lmh_dofs(m) + 3 * m.n_nodes; } }
+    };
+
+    nlohmann::json report = nlohmann::json::array();
+    std::deque<std::string> tags; // code points keep pointers to the tags
+    std::vector< std::shared_ptr<CodePoint> > cp_vec;
+    for (unsigned int dim=1; dim<=3; ++dim)
+        for (bool unstructured : {false, true}) {
+            std::string mesh_file = "generated_" + std::to_string(dim) + "d_"
+                    + (unstructured ? "unstructured" : "structured") + ".msh";
+            GeneratedMeshInfo mesh = make_mesh(mesh_file, dim, unstructured);
+
+            for (auto &problem : problems) {
+                if (std::find(problem.dims.begin(), problem.dims.end(), dim) == problem.dims.end()) continue;
+
+                // timer tag is given by the run, START_TIMER accepts only constexpr strings
+                tags.push_back(problem.name + "_" + mesh_file);
+                cp_vec.emplace_back( new CODE_POINT(tags.back().c_str()) );
+                TimerFrame timer = TimerFrame( *cp_vec.back() );
+                report.push_back( run_problem(problem, mesh_file, mesh) );
+                Profiler::instance()->stop_timer( *cp_vec.back() );
+
+                if (rank_ == 0)
+                    std::cout << report.back().dump() << std::endl;
+            }
+        }
+
+    if (rank_ == 0) {
+        std::ofstream out("generated_problems_bench.json");
+        out << report.dump(2) << std::endl;
+    }
+    FilePath fp("generated_problems_profiler.json", FilePath::output_file);
+    Profiler::instance()->output(MPI_COMM_WORLD, fp.filename());
+    Profiler::uninitialize();
+}
@@ -0,0 +1,28 @@
+/*
+ * nonlinear_tolerance_test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+#include <flow_gtest.hh>
+
+#include "flow/darcy_flow_lmh.hh"
+
+
+TEST(DarcyLMH, eisenstat_walker_tolerance) {
+    // tolerance given by the decrease of the residual
+    EXPECT_NEAR(0.009, DarcyLMH::eisenstat_walker_tolerance(0.1, 0.1, 1e-10, 1.0, 0.1), 1e-14);
+    EXPECT_NEAR(9e-7, DarcyLMH::eisenstat_walker_tolerance(0.1, 0.1, 1e-10, 1.0, 1e-3), 1e-20);
+
+    // slow convergence, bounded by the maximal tolerance
+    EXPECT_DOUBLE_EQ(0.1, DarcyLMH::eisenstat_walker_tolerance(0.1, 0.1, 1e-10, 1.0, 0.9));
+
+    // safeguard prevents a sudden decrease of large tolerance
+    EXPECT_NEAR(0.225, DarcyLMH::eisenstat_walker_tolerance(0.5, 0.9, 1e-10, 1.0, 0.1), 1e-14);
+
+    // do not solve the linear system more precisely than the nonlinear tolerance requires
+    EXPECT_NEAR(0.05, DarcyLMH::eisenstat_walker_tolerance(0.1, 0.1, 1e-6, 1e-4, 1e-5), 1e-14);
+    EXPECT_DOUBLE_EQ(0.1, DarcyLMH::eisenstat_walker_tolerance(0.1, 0.1, 1e-6, 1.0, 2e-6));
+}
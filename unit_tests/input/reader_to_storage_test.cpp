@@ -183,6 +183,8 @@ TEST_F(InputReaderToStorageTest, Array) {
         EXPECT_EQ(3, storage_->get_array_size());
         EXPECT_EQ(3.2, storage_->get_item(0)->get_double() );
         EXPECT_EQ(4, storage_->get_item(1)->get_double() );
+        // array of doubles is stored compactly
+        EXPECT_NE((void *)NULL, dynamic_cast<StorageDoubleArray *>(storage_) );
     }
 
     {  //YAML format
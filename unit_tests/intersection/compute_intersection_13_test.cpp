@@ -21,6 +21,7 @@
 #include "intersection/intersection_aux.hh"
 #include "intersection/intersection_point_aux.hh"
 #include "intersection/intersection_local.hh"
+#include "intersection/plucker.hh"
 
 #include "compute_intersection_test.hh"
 
@@ -156,3 +157,24 @@ TEST(intersections_13d, all) {
         }
     }
 }
+
+
+TEST(plucker_batch, products) {
+    arma::vec3 a({0.1, 0.2, 0.3}), b({1.0, -0.5, 0.7});
+    Plucker line(a, b, true);
+
+    auto point_c = [](unsigned int i) { return arma::vec3({0.3*i, 1.0 - 0.1*i, 0.5}); };
+    auto point_d = [](unsigned int i) { return arma::vec3({-0.2*i, 0.4, 1.0 + 0.3*i}); };
+    PluckerBatch batch;
+    for(unsigned int i=0; i<7; i++) batch.add(point_c(i), point_d(i));
+    EXPECT_EQ(7, batch.size());
+
+    std::vector<double> products;
+    batch.products(line, products);
+    ASSERT_EQ(7, products.size());
+    for(unsigned int i=0; i<7; i++) {
+        Plucker other(point_c(i), point_d(i), true);
+        EXPECT_DOUBLE_EQ(line * other, products[i]);
+        EXPECT_DOUBLE_EQ(other.scale(), batch.scale(i));
+    }
+}
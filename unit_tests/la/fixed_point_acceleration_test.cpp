@@ -0,0 +1,92 @@
+#define TEST_USE_MPI
+#define FEAL_OVERRIDE_ASSERTS
+
+#include <flow_gtest_mpi.hh>
+#include <cmath>
+#include "la/fixed_point_acceleration.hh"
+#include "la/vector_mpi.hh"
+
+
+/**
+ * Linear fixed point map G(x)_i = c_i x_i + 1 with contraction factors c_i.
+ * The second state vector is affine image 2x+1 of the first one.
+ */
+class FixedPointProblem {
+public:
+	FixedPointProblem(std::vector<double> c)
+	: c_(c), x_((unsigned int)c.size()), y_((unsigned int)c.size())
+	{
+		set_state(std::vector<double>(c.size(), 0.0));
+	}
+
+	void set_state(const std::vector<double> &x) {
+		for (unsigned int i=0; i<c_.size(); ++i) {
+			x_.set(i, x[i]);
+			y_.set(i, 2*x[i] + 1);
+		}
+	}
+
+	/// Replace x by G(x).
+	void apply() {
+		std::vector<double> x(c_.size());
+		for (unsigned int i=0; i<c_.size(); ++i) x[i] = c_[i]*x_.get(i) + 1;
+		set_state(x);
+	}
+
+	/// Maximal error of both state vectors.
+	double error() {
+		double err = 0.0;
+		for (unsigned int i=0; i<c_.size(); ++i) {
+			double x_exact = 1.0 / (1.0 - c_[i]);
+			err = std::max(err, std::fabs(x_.get(i) - x_exact));
+			err = std::max(err, std::fabs(y_.get(i) - (2*x_exact + 1)));
+		}
+		double glob_err;
+		MPI_Allreduce(&err, &glob_err, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD);
+		return glob_err;
+	}
+
+	/// Number of iterations to reach given tolerance.
+	unsigned int solve(FixedPointAcceleration &acc, double tol, unsigned int max_it) {
+		acc.start({&x_, &y_});
+		unsigned int it=0;
+		while (error() > tol && it < max_it) {
+			apply();
+			acc.accelerate({&x_, &y_});
+			it++;
+		}
+		return it;
+	}
+
+	std::vector<double> c_;
+	VectorMPI x_, y_;
+};
+
+
+TEST(FixedPointAcceleration, plain_iteration) {
+	PetscInitialize(0, PETSC_NULL, PETSC_NULL, PETSC_NULL);
+
+	FixedPointProblem problem({0.5, 0.7, 0.9, 0.95});
+	FixedPointAcceleration acc(FixedPointAcceleration::none);
+	EXPECT_GT( problem.solve(acc, 1e-8, 1000), 300 );
+}
+
+
+TEST(FixedPointAcceleration, aitken) {
+	PetscInitialize(0, PETSC_NULL, PETSC_NULL, PETSC_NULL);
+
+	// same contraction in all components, Aitken relaxation finds the optimal factor 1/(1-c)
+	FixedPointProblem problem({0.9, 0.9, 0.9});
+	FixedPointAcceleration acc(FixedPointAcceleration::aitken, 1, 0.5);
+	EXPECT_LE( problem.solve(acc, 1e-8, 100), 2 );
+	EXPECT_NEAR( acc.relaxation(), 10.0, 1e-8 );
+}
+
+
+TEST(FixedPointAcceleration, anderson) {
+	PetscInitialize(0, PETSC_NULL, PETSC_NULL, PETSC_NULL);
+
+	FixedPointProblem problem({0.5, 0.7, 0.9, 0.95});
+	FixedPointAcceleration acc(FixedPointAcceleration::anderson, 5);
+	EXPECT_LE( problem.solve(acc, 1e-8, 100), 10 );
+}
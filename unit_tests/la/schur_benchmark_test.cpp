@@ -0,0 +1,112 @@
+#define TEST_USE_PETSC
+
+#include "flow_gtest_mpi.hh"
+
+#include "la/distribution.hh"
+#include "la/schur.hh"
+#include "la/linsys.hh"
+#include "la/linsys_PETSC.hh"
+#include "system/sys_profiler.hh"
+
+#include <petscmat.h>
+#include <vector>
+
+
+const int
+    a_block_size = 3,
+    n_blocks = 20000,
+    n_steps = 20;
+
+
+class SchurComplementBenchmark : public SchurComplement {
+public:
+	SchurComplementBenchmark(IS ia, Distribution *ds)
+	: SchurComplement(ds, ia)
+	{}
+
+	using SchurComplement::form_schur;
+
+	/**
+	 * Fill local part of the matrix
+	 * A  B
+	 * Bt 0
+	 *
+	 * where A is block diagonal with blocks scaled by @p scale. Every block of A is coupled
+	 * with two DOFs of the complement (local DOFs k and k+1).
+	 */
+	void fill_matrix(Distribution &ds, double scale) {
+		int compl_begin = ds.begin() + n_blocks*a_block_size;
+		for (int k=0; k<n_blocks; k++) {
+			std::vector<PetscInt> a_rows(a_block_size);
+			for (int i=0; i<a_block_size; i++) a_rows[i] = ds.begin() + k*a_block_size + i;
+			std::vector<PetscScalar> a_vals(a_block_size*a_block_size, scale);
+			for (int i=0; i<a_block_size; i++) a_vals[i*a_block_size + i] = 4*scale;
+			mat_set_values(a_block_size, &a_rows[0], a_block_size, &a_rows[0], &a_vals[0]);
+
+			PetscInt b_cols[2] = { compl_begin + k, compl_begin + (k+1) % n_blocks };
+			PetscScalar b_vals[3][2] = { {1.0, 0.0}, {0.0, 1.0}, {0.5, 0.5} };
+			for (int i=0; i<a_block_size; i++) {
+				mat_set_values(1, &a_rows[i], 2, b_cols, b_vals[i]);
+				for (int j=0; j<2; j++) mat_set_values(1, &b_cols[j], 1, &a_rows[i], &b_vals[i][j]);
+			}
+
+			PetscScalar c_val = 0.0;
+			mat_set_values(1, &b_cols[0], 1, &b_cols[0], &c_val);
+
+			std::vector<PetscScalar> rhs_vals(a_block_size, 1.0);
+			rhs_set_values(a_block_size, &a_rows[0], &rhs_vals[0]);
+		}
+	}
+
+	/// Return diagonal entry of the first local row of the complement.
+	double compl_diagonal() {
+		Mat compl_mat = *( get_system()->get_matrix() );
+		PetscInt row, ncols;
+		const PetscInt *cols;
+		const PetscScalar *vals;
+		double diag = 0.0;
+		MatGetOwnershipRange(compl_mat, &row, PETSC_NULL);
+		MatGetRow(compl_mat, row, &ncols, &cols, &vals);
+		for (PetscInt j=0; j<ncols; j++)
+			if (cols[j] == row) diag = vals[j];
+		MatRestoreRow(compl_mat, row, &ncols, &cols, &vals);
+		return diag;
+	}
+};
+
+
+// Cost of forming the Schur complement in every step of a transient problem, i.e. values
+// of the matrix change but its structure is the same.
+TEST(schur, form_schur_steps) {
+    Profiler::instance();
+
+    Distribution all_ds(n_blocks*(a_block_size+1), MPI_COMM_WORLD);
+    IS set;
+    ISCreateStride(PETSC_COMM_WORLD, n_blocks*a_block_size, all_ds.begin(), 1, &set);
+
+    SchurComplementBenchmark * schur = new SchurComplementBenchmark(set, &all_ds);
+    schur->set_solution();
+    schur->set_positive_definite();
+    schur->start_allocation();
+    schur->fill_matrix(all_ds, 1.0); // preallocate matrix
+    schur->set_complement( new LinSys_PETSC( schur->make_complement_distribution() ) );
+
+    double first_diag = 0.0;
+    START_TIMER("SchurComplement_form_schur_steps");
+    for (int step=0; step<n_steps; step++) {
+        double scale = 1.0 + step;
+        schur->start_add_assembly();
+        schur->mat_zero_entries();
+        schur->rhs_zero_entries();
+        schur->fill_matrix(all_ds, scale);
+        schur->finish_assembly();
+        schur->form_schur();
+
+        // complement is proportional to inverse of A
+        if (step == 0) first_diag = schur->compl_diagonal();
+        EXPECT_NEAR( first_diag, scale * schur->compl_diagonal(), 1e-12 * first_diag );
+    }
+    END_TIMER("SchurComplement_form_schur_steps");
+
+    delete schur;
+}
@@ -178,6 +178,175 @@ TEST(LinSys_PETSC, set_local_system_mm) {
 
 
 
+#if PETSC_VERSION_GE(3,17,0)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Test repeated assembly of overlapping m x m blocks through COO slots, compare with MatSetValues.
+TEST(LinSys_PETSC, coo_assembly_mm) {
+    // setup FilePath directories
+    FilePath::set_io_dirs(".",string(UNIT_TESTS_SRC_DIR)+"/la/","",".");
+
+    const int n_blocks = ls_size - m + 1, n_steps = 20;
+    Distribution ds(ls_size, MPI_COMM_WORLD);
+    LinSys_PETSC ls(&ds), ls_coo(&ds);
+    ls_coo.set_coo_assembly(true);
+    allocate_linsys(&ls);
+    allocate_linsys(&ls_coo);
+
+    double vals[m*m];
+    int rows[m];
+    for(unsigned int step = 0; step < n_steps; step++) {
+        for (LinSys_PETSC *p_ls : {&ls, &ls_coo}) {
+            if (p_ls == &ls_coo) START_TIMER("LinSys_PETSC_coo_assembly_mm");
+            p_ls->start_add_assembly();
+            p_ls->mat_zero_entries();
+            for(int k = 0; k < n_blocks; k++) {
+                for(int i = 0; i<m; i++) rows[i] = k + i;
+                for(int i = 0; i<m*m; i++) vals[i] = 1.0 + step + (i % m);
+                p_ls->mat_set_values(m, rows, m, rows, vals);
+            }
+            p_ls->finish_assembly();
+            if (p_ls == &ls_coo) END_TIMER("LinSys_PETSC_coo_assembly_mm");
+        }
+
+        Mat diff;
+        double norm;
+        MatConvert(*ls.get_matrix(), MATSAME, MAT_INITIAL_MATRIX, &diff);
+        MatAXPY(diff, -1.0, *ls_coo.get_matrix(), DIFFERENT_NONZERO_PATTERN);
+        MatNorm(diff, NORM_FROBENIUS, &norm);
+        EXPECT_LT(norm, 1e-12);
+        MatDestroy(&diff);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Test COO assembly with changed sequence of entries, assembly falls back to MatSetValues and records it again.
+TEST(LinSys_PETSC, coo_assembly_changed_sequence) {
+    // setup FilePath directories
+    FilePath::set_io_dirs(".",string(UNIT_TESTS_SRC_DIR)+"/la/","",".");
+
+    const int n_blocks = ls_size - m + 1, n_steps = 8;
+    Distribution ds(ls_size, MPI_COMM_WORLD);
+    LinSys_PETSC ls(&ds), ls_coo(&ds);
+    ls_coo.set_coo_assembly(true);
+    allocate_linsys(&ls);
+    allocate_linsys(&ls_coo);
+
+    double vals[m*m];
+    int rows[m];
+    for(unsigned int step = 0; step < n_steps; step++) {
+        // order of blocks is reversed in steps 3, 4 and changes in every step from step 6
+        bool reversed = (step >= 3 && step < 5) || (step >= 6 && step % 2 == 0);
+        for (LinSys_PETSC *p_ls : {&ls, &ls_coo}) {
+            p_ls->start_add_assembly();
+            p_ls->mat_zero_entries();
+            for(int i_block = 0; i_block < n_blocks; i_block++) {
+                int k = reversed ? n_blocks - 1 - i_block : i_block;
+                for(int i = 0; i<m; i++) rows[i] = k + i;
+                for(int i = 0; i<m*m; i++) vals[i] = 1.0 + step + k + (i % m);
+                p_ls->mat_set_values(m, rows, m, rows, vals);
+            }
+            p_ls->finish_assembly();
+        }
+
+        Mat diff;
+        double norm;
+        MatConvert(*ls.get_matrix(), MATSAME, MAT_INITIAL_MATRIX, &diff);
+        MatAXPY(diff, -1.0, *ls_coo.get_matrix(), DIFFERENT_NONZERO_PATTERN);
+        MatNorm(diff, NORM_FROBENIUS, &norm);
+        EXPECT_LT(norm, 1e-12);
+        MatDestroy(&diff);
+    }
+}
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Test reuse of the preconditioner of LinSys_PETSC in repeated solves.
+class LinSysPcReuse : public LinSys_PETSC {
+public:
+    LinSysPcReuse(Distribution *ds)
+    : LinSys_PETSC(ds)
+    {
+        set_solution();
+        set_tolerances(1e-10, 1e-12, 1e4, 1000);
+    }
+
+    void set_pc_reuse(unsigned int steps, double it_ratio)
+    { pc_reuse_steps_ = steps; pc_reuse_it_ratio_ = it_ratio; }
+
+    /// Assemble tridiagonal matrix with given diagonal, matrix is not changed for diag <= 0.0.
+    void assemble(double diag) {
+        start_add_assembly();
+        rhs_zero_entries();
+        if (diag > 0.0) mat_zero_entries();
+        for(int i = rows_ds_->begin(); i < (int)rows_ds_->end(); i++) {
+            if (diag > 0.0) {
+                mat_set_value(i, i, diag);
+                if (i > 0) mat_set_value(i, i-1, -1.0);
+                if (i < ls_size-1) mat_set_value(i, i+1, -1.0);
+            }
+            rhs_set_value(i, 1.0);
+        }
+        finish_assembly();
+    }
+
+    /// Solve the system, return true if the preconditioner was reused.
+    bool solve_reused() {
+        solve();
+        EXPECT_GT(reason, 0);
+        PetscBool flag;
+        KSPGetReusePreconditioner(system, &flag);
+        return flag == PETSC_TRUE;
+    }
+};
+
+TEST(LinSys_PETSC, pc_reuse) {
+    // setup FilePath directories
+    FilePath::set_io_dirs(".",string(UNIT_TESTS_SRC_DIR)+"/la/","",".");
+
+    Distribution ds(ls_size, MPI_COMM_WORLD);
+    LinSysPcReuse ls(&ds);
+    allocate_linsys(&ls);
+
+    // no reuse steps: preconditioner is rebuilt after every change of the matrix
+    ls.assemble(4.0);
+    EXPECT_FALSE(ls.solve_reused());
+    ls.assemble(0.0);
+    EXPECT_TRUE(ls.solve_reused());
+    ls.assemble(5.0);
+    EXPECT_FALSE(ls.solve_reused());
+
+    // preconditioner forced by the owner of the system
+    ls.set_reuse_preconditioner(true);
+    ls.assemble(6.0);
+    EXPECT_TRUE(ls.solve_reused());
+    ls.set_reuse_preconditioner(false);
+    ls.assemble(4.0);
+    EXPECT_FALSE(ls.solve_reused());
+
+    // two solves with changed matrix reuse the preconditioner
+    ls.set_pc_reuse(2, 1000.0);
+    ls.assemble(5.0);
+    EXPECT_TRUE(ls.solve_reused());
+    ls.assemble(6.0);
+    EXPECT_TRUE(ls.solve_reused());
+    ls.assemble(0.0);
+    EXPECT_TRUE(ls.solve_reused());
+    ls.assemble(7.0);
+    EXPECT_FALSE(ls.solve_reused());
+
+    // any iteration exceeds zero ratio, preconditioner is rebuilt after the first reuse
+    ls.set_pc_reuse(5, 0.0);
+    ls.assemble(4.0);
+    EXPECT_TRUE(ls.solve_reused());
+    ls.assemble(5.0);
+    EXPECT_FALSE(ls.solve_reused());
+    ls.assemble(6.0);
+    EXPECT_TRUE(ls.solve_reused());
+}
+
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Test AIJ matrix direct PETSC assembly of an m x m continuous matrix, whole block at once.
 TEST(PETSC_mat, mat_set_values_mm) {
@@ -9,6 +9,8 @@
 
 #include <flow_gtest.hh>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
 #include <string>
 #include <mesh_constructor.hh>
 
@@ -56,3 +58,105 @@ TEST(GMSHReader, read_mesh_from_file) {
 
     delete mesh;
 }
+
+
+/// Write small binary GMSH file with three elements and two time frames of ElementData.
+void write_binary_gmsh(const std::string &file_name) {
+    std::ofstream out(file_name, std::ios_base::out | std::ios_base::binary);
+    auto write_int = [&out](int val) { out.write(reinterpret_cast<const char *>(&val), sizeof(int)); };
+    auto write_double = [&out](double val) { out.write(reinterpret_cast<const char *>(&val), sizeof(double)); };
+
+    out << "$MeshFormat\n2.2 1 8\n";
+    write_int(1);
+    out << "\n$EndMeshFormat\n";
+
+    out << "$Nodes\n5\n";
+    double coords[5][3] = { {0,0,0}, {1,0,0}, {0,1,0}, {0,0,1}, {1,1,1} };
+    for (int i=0; i<5; ++i) {
+        write_int(i+1);
+        for (int j=0; j<3; ++j) write_double(coords[i][j]);
+    }
+    out << "\n$EndNodes\n";
+
+    out << "$Elements\n3\n";
+    write_int(4); write_int(2); write_int(2); // block of two tetrahedra with two tags
+    for (int id : {1, 2}) {
+        write_int(id); write_int(1); write_int(1);
+        for (int n=id; n<id+4; ++n) write_int(n);
+    }
+    write_int(2); write_int(1); write_int(3);  // block of one triangle with three tags
+    write_int(3); write_int(2); write_int(2); write_int(0);
+    for (int n : {2, 3, 4}) write_int(n);
+    out << "\n$EndElements\n";
+
+    for (int t=0; t<2; ++t) {
+        out << "$ElementData\n1\n\"scalar\"\n1\n" << t << ".0\n3\n0\n1\n3\n";
+        for (int id=1; id<=3; ++id) {
+            write_int(id);
+            write_double(id + 10.0*t);
+        }
+        out << "\n$EndElementData\n";
+    }
+}
+
+
+TEST(GMSHReader, read_binary_file) {
+    Profiler::instance();
+    FilePath::set_io_dirs(".",".","",".");
+    write_binary_gmsh("gmsh_binary_test.msh");
+
+	std::string mesh_in_string = "{mesh_file=\"gmsh_binary_test.msh\"}";
+	Mesh * mesh = mesh_constructor(mesh_in_string);
+    auto reader = reader_constructor(mesh_in_string);
+	reader->read_physical_names(mesh);
+	reader->read_raw_mesh(mesh);
+    EXPECT_EQ(5, mesh->n_nodes());
+    EXPECT_EQ(3, mesh->n_elements());
+
+    mesh->setup_topology();
+    reader->set_element_ids(*mesh);
+    for (double time : {0.0, 1.0}) {
+        BaseMeshReader::HeaderQuery header_params("scalar", time, OutputTime::DiscreteSpace::ELEM_DATA);
+        auto header = reader->find_header(header_params);
+        EXPECT_EQ(3, header.n_entities);
+        std::vector<double> &vec = *( reader->get_element_data<double>(header, 3, 1, 3) );
+        for (unsigned int i=0; i<3; ++i) EXPECT_DOUBLE_EQ(i + 1.0 + 10.0*time, vec[i]);
+    }
+
+    delete mesh;
+}
+
+
+TEST(GMSHReader, header_index) {
+    Profiler::instance();
+    FilePath::set_io_dirs(".",".","",".");
+
+    // copy mesh with ElementData sections to working directory, index file is created next to it
+    {
+        std::ifstream src(string(UNIT_TESTS_SRC_DIR) + "/fields/simplest_cube_base_data.msh", std::ios_base::binary);
+        std::ofstream dst("gmsh_index_test.msh", std::ios_base::binary);
+        dst << src.rdbuf();
+    }
+    std::remove("gmsh_index_test.msh.index");
+    std::size_t min_file_size = GmshMeshReader::index_min_file_size;
+    GmshMeshReader::index_min_file_size = 0;
+
+    FilePath file_name("gmsh_index_test.msh", FilePath::input_file);
+    GmshMeshReader scan_reader(file_name);   // scans file and writes index
+    EXPECT_TRUE( std::ifstream("gmsh_index_test.msh.index").is_open() );
+    GmshMeshReader index_reader(file_name);  // reads index
+
+    for (double time : {0.0, 1.0}) {
+        BaseMeshReader::HeaderQuery header_params("vector_fixed", time, OutputTime::DiscreteSpace::ELEM_DATA);
+        auto scan_header = scan_reader.find_header(header_params);
+        auto index_header = index_reader.find_header(header_params);
+        EXPECT_EQ(scan_header.field_name, index_header.field_name);
+        EXPECT_EQ(scan_header.time, index_header.time);
+        EXPECT_EQ(scan_header.n_components, index_header.n_components);
+        EXPECT_EQ(scan_header.n_entities, index_header.n_entities);
+        EXPECT_EQ((std::streamoff)scan_header.position.file_position_, (std::streamoff)index_header.position.file_position_);
+        EXPECT_EQ(scan_header.position.line_counter_, index_header.position.line_counter_);
+    }
+
+    GmshMeshReader::index_min_file_size = min_file_size;
+}
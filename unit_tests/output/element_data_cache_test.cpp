@@ -14,6 +14,9 @@
 #include "system/tokenizer.hh"
 #include "la/distribution.hh"
 
+#include <cmath>
+#include <cstring>
+
 
 /* Tests of ElementDataCacheBase functionality */
 TEST(ElementDataCache, base_data_cache)
@@ -95,6 +98,44 @@ TEST(ElementDataCache, print_data)
 }
 
 
+TEST(ElementDataCache, compact_output)
+{
+	ElementDataCache<double> data_cache("out_cache", 1, 10, "");
+	for (unsigned int i=0; i<data_cache.n_values(); ++i) {
+		data_cache[i] = 1.0 + i*0.33;
+    }
+
+	// quantization to multiples of 0.2
+	data_cache.quantize(0.1);
+	for (unsigned int i=0; i<data_cache.n_values(); ++i) {
+		EXPECT_NEAR( data_cache[i], 1.0 + i*0.33, 0.1 + 1e-12 );
+		EXPECT_NEAR( data_cache[i] / 0.2, std::round(data_cache[i] / 0.2), 1e-9 );
+	}
+
+	// single precision binary output
+	data_cache.set_single_precision();
+	EXPECT_EQ(data_cache.vtk_type(), ElementDataCacheBase::VTKValueType::VTK_FLOAT32);
+	std::stringstream ss;
+	data_cache.print_binary_all(ss);
+	std::string out = ss.str();
+	EXPECT_EQ(out.size(), sizeof(unsigned long long int) + 10*sizeof(float));
+	unsigned long long int data_size;
+	memcpy(&data_size, out.data(), sizeof(unsigned long long int));
+	EXPECT_EQ(data_size, 10*sizeof(float));
+	float val;
+	memcpy(&val, out.data() + sizeof(unsigned long long int) + 3*sizeof(float), sizeof(float));
+	EXPECT_FLOAT_EQ(val, (float)data_cache[3]);
+
+	// integer data are not changed
+	ElementDataCache<unsigned int> int_cache("int_cache", 1, 4, "");
+	for (unsigned int i=0; i<int_cache.n_values(); ++i) int_cache[i] = i;
+	int_cache.quantize(1.0);
+	int_cache.set_single_precision();
+	for (unsigned int i=0; i<int_cache.n_values(); ++i) EXPECT_EQ( int_cache[i], i );
+	EXPECT_EQ(int_cache.vtk_type(), ElementDataCacheBase::VTKValueType::VTK_UINT32);
+}
+
+
 TEST(ElementDataCache, value_operations)
 {
 	ElementDataCache<double> data_cache("data_cache", 3, 3, "");
@@ -117,8 +117,8 @@ public:
 
 class TestObserve : public Observe {
 public:
-    TestObserve(Mesh &mesh, Input::Array in_array)
-    : Observe("test_eq", mesh, in_array, 6, std::make_shared<TimeUnitConversion>())
+    TestObserve(Mesh &mesh, Input::Array in_array, std::string observe_name = "test_eq")
+    : Observe(observe_name, mesh, in_array, 6, std::make_shared<TimeUnitConversion>())
     {
         for(auto &point: this->points_) my_points.push_back(TestObservePoint(point));
     }
@@ -186,6 +186,18 @@ public:
 
 
     }
+    // Compare points found by Observe (bulk search in BIH tree) with search of every single point.
+    void check_single_point_search(Mesh &mesh) {
+        for (auto &point : my_points) {
+            TestObservePoint single_point(point);
+            single_point.observe_data_ = ObservePointData();
+            single_point.find_observe_point(mesh);
+            EXPECT_EQ(single_point.observe_data_.element_idx_, point.observe_data_.element_idx_);
+            EXPECT_ARMA_EQ(single_point.observe_data_.global_coords_, point.observe_data_.global_coords_);
+            EXPECT_ARMA_EQ(single_point.observe_data_.local_coords_, point.observe_data_.local_coords_);
+        }
+    }
+
     std::vector<TestObservePoint> my_points;
 
 };
@@ -309,3 +321,37 @@ TEST(Observe, all) {
 //        EXPECT_EQ(str_obs_file_ref.str(), str_obs_file.str());
 }
 
+
+TEST(Observe, find_observe_points) {
+    Profiler::instance();
+    armadillo_setup();
+
+    // grid of points inside and outside of the cube, various snapping
+    std::stringstream points_input;
+    points_input << "{ observe_points: [";
+    for (double x : {-1.2, -0.7, -0.1, 0.4, 0.9})
+        for (double y : {-0.9, -0.3, 0.5, 1.1})
+            for (double z : {-0.8, 0.2, 0.7}) {
+                points_input << "{ point: [" << x << ", " << y << ", " << z << "], search_radius: 10 },";
+                points_input << "{ point: [" << x << ", " << y << ", " << z << "], snap_region: \"2D XY diagonal\", snap_dim: 2, search_radius: 10 },";
+            }
+    points_input << "{ point: [-0.5, -0.5, 0], snap_region: \"1D diagonal\", snap_dim: 0 } ] }";
+
+    auto output_type = Input::Type::Record("Output", "")
+        .declare_key("observe_points", Input::Type::Array(ObservePoint::get_input_type()), Input::Type::Default::obligatory(), "")
+        .close();
+    auto in_rec = Input::ReaderToStorage(points_input.str(), output_type, Input::FileFormat::format_JSON)
+        .get_root_interface<Input::Record>();
+
+    FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/mesh/simplest_cube.msh", FilePath::input_file);
+    Mesh *mesh = mesh_full_constructor("{ mesh_file=\"" + (string)mesh_file + "\", optimize_mesh=false, global_snap_radius=1.0 }");
+
+    {
+        std::shared_ptr<TestObserve> obs = std::make_shared<TestObserve>(*mesh, in_rec.val<Input::Array>("observe_points"),
+                "test_find_points");
+        EXPECT_EQ(121, obs->my_points.size());
+        obs->check_single_point_search(*mesh);
+    }
+
+    delete mesh;
+}
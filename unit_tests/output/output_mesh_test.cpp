@@ -123,30 +123,12 @@ public:
     
     template<int dim> void refine_single_element(AuxElement &el)
     {
-        const int spacedim = 3;
         el.level = 0;
-        std::vector<AuxElement> refs;
-        
         std::vector<double> disc_coords;
-        std::vector<unsigned int> disc_connectivity;
-        
+
         this->refine_by_error_ = false;
-        this->refine_aux_element<dim>(el, refs, ElementAccessor<3>());
-        
-        disc_coords.resize(spacedim * (dim+1) * refs.size());
-        disc_connectivity.resize((dim+1) * refs.size());
-        
-        //gather coords and connectivity (disccontinous)
-        for(unsigned int i=0; i < refs.size(); i++)
-            for(unsigned int j=0; j < dim+1; j++)
-            {
-                unsigned int con = i*(dim+1) + j;
-                disc_connectivity[con] = con;
-                
-                for(unsigned int k=0; k < spacedim; k++)
-                    disc_coords[spacedim*con + k] = refs[i].nodes[j][k];
-            }
-            
+        this->refine_aux_element<dim>(el, disc_coords, ElementAccessor<3>());
+
         // correct data for the given aux element
         static const std::vector<double> res_coords[] = {
             {},
@@ -258,3 +240,34 @@ TEST_F(TestOutputMesh, refine) {
     el3.nodes = {{0, 0, 0}, {a, 0, 0}, {0, a, 0}, {0, 0, a}};
     this->refine_single_element<3>(el3);
 }
+
+
+TEST_F(TestOutputMesh, refine_by_error) {
+    // f = 1 + x^2, relative differences between the average at nodes and the value at centre:
+    // [0,3]: 0.69, [0,1.5]: 0.36, [1.5,3]: 0.09
+    unsigned int n_calls = 0;
+    this->set_error_control_field(
+        [&n_calls](const Armor::array &point_list, const ElementAccessor<3> &, std::vector<double> &value_list)
+        {
+            n_calls++;
+            for (unsigned int i=0; i<point_list.size(); i++) {
+                double x = point_list.vec<3>(i)(0);
+                value_list[i] = 1 + x*x;
+            }
+        });
+    this->refine_by_error_ = true;
+    this->refinement_error_tolerance_ = 0.2;
+
+    AuxElement el;
+    el.nodes = {{0, 0, 0}, {3, 0, 0}};
+    el.level = 0;
+    std::vector<double> coords;
+    this->refine_aux_element<1>(el, coords, ElementAccessor<3>());
+
+    // criterion is evaluated once per level, last level is given by max_level
+    EXPECT_EQ(2, n_calls);
+    std::vector<double> res_coords = { 0, 0, 0, 0.75, 0, 0, 0.75, 0, 0, 1.5, 0, 0, 1.5, 0, 0, 3, 0, 0 };
+    ASSERT_EQ(res_coords.size(), coords.size());
+    for(unsigned int i=0; i < coords.size(); i++)
+        EXPECT_DOUBLE_EQ(res_coords[i], coords[i]);
+}
@@ -16,6 +16,8 @@
 #include "io/output_time.hh"
 #include "io/output_vtk.hh"
 #include "io/output_mesh.hh"
+#include "io/reader_cache.hh"
+#include "io/msh_basereader.hh"
 #include "mesh/mesh.h"
 #include "io/msh_gmshreader.h"
 #include "input/reader_to_storage.hh"
@@ -44,16 +46,23 @@ format: !vtk
   variant: binary
 )YAML";
 
+const string test_output_time_single_precision = R"YAML(
+file: ./test_single.pvd
+format: !vtk
+  variant: binary
+  single_precision: true
+)YAML";
+
 
 class TestOutputVTK : public OutputVTK, public std::enable_shared_from_this<OutputVTK> {
 public:
-    TestOutputVTK()
+    TestOutputVTK(std::string mesh_file_name = "/fields/simplest_cube_3d.msh")
     : OutputVTK()
     {
         Profiler::instance();
         LoggerOptions::get_instance().set_log_file("");
 
-        FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/fields/simplest_cube_3d.msh", FilePath::input_file);
+        FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + mesh_file_name, FilePath::input_file);
         this->_mesh = mesh_full_constructor("{ mesh_file=\"" + (string)mesh_file + "\", optimize_mesh=false }");
 
         component_names = { "comp_0", "comp_1", "comp_2" };
@@ -155,6 +164,27 @@ public:
 	    EXPECT_EQ(str_vtk_file_ref.str(), str_vtk_file.str());
 	}
 
+	// read vector field written with values of given type back to double values
+	void check_vector_field_file(std::string result_file, DataType data_type)
+	{
+	    FilePath file_path(result_file, FilePath::input_file);
+	    ReaderCache::get_mesh(file_path)->check_compatible_mesh( *(this->_mesh) );
+	    ReaderCache::get_element_ids(file_path, *(this->_mesh));
+
+	    BaseMeshReader::HeaderQuery header_params("vector_field", 0.0, OutputTime::DiscreteSpace::ELEM_DATA);
+	    auto header = ReaderCache::get_reader(file_path)->find_header(header_params);
+	    EXPECT_EQ( data_type, header.type );
+
+	    unsigned int n_elements = this->_mesh->n_elements();
+	    typename ElementDataCache<double>::CacheData data =
+	            ReaderCache::get_reader(file_path)->template get_element_data<double>(header, n_elements, 3, false);
+	    std::vector<double> &vec = *( data.get() );
+	    EXPECT_EQ(3*n_elements, vec.size());
+	    for (unsigned int j=0; j<vec.size(); j++) {
+	        EXPECT_DOUBLE_EQ( 0.5*(j%3+1), vec[j] );
+	    }
+	}
+
 	void set_current_step(int step) {
 		this->current_step = step;
 	}
@@ -217,6 +247,34 @@ TEST(TestOutputVTK, write_data_binary) {
     output_vtk->check_result_file("test1/test1-000000.vtu", "test_output_vtk_binary_ref.vtu");
 }
 
+TEST(TestOutputVTK, write_data_binary_frames) {
+	std::shared_ptr<TestOutputVTK> output_vtk = std::make_shared<TestOutputVTK>();
+
+	output_vtk->init_mesh(test_output_time_binary);
+	for (int step=0; step<2; ++step) {
+	    output_vtk->clear_data();
+	    output_vtk->set_current_step(step);
+	    output_vtk->set_field_data<3, FieldValue<0>::Scalar>("scalar_field", "0.5", "0.5");
+	    output_vtk->set_field_data<3, FieldValue<3>::VectorFixed>("vector_field", "[0.5, 1.0, 1.5]", "0.5 1.0 1.5");
+	    output_vtk->set_field_data<3, FieldValue<3>::TensorFixed>("tensor_field", "[[1, 2, 3], [4, 5, 6], [7, 8, 9]]", "1 2 3; 4 5 6; 7 8 9");
+	    output_vtk->write_data();
+	}
+
+	// second frame reuses cached geometry and contains only its own data
+	output_vtk->check_result_file("test1/test1-000001.vtu", "test_output_vtk_binary_ref.vtu");
+}
+
+TEST(TestOutputVTK, write_read_single_precision) {
+	std::shared_ptr<TestOutputVTK> output_vtk = std::make_shared<TestOutputVTK>();
+
+	output_vtk->init_mesh(test_output_time_single_precision);
+    output_vtk->set_current_step(0);
+    output_vtk->set_field_data<3, FieldValue<3>::VectorFixed>("vector_field", "[0.5, 1.0, 1.5]", "0.5 1.0 1.5");
+    output_vtk->write_data();
+
+    output_vtk->check_vector_field_file("test_single/test_single-000000.vtu", DataType::float32);
+}
+
 #ifdef FLOW123D_HAVE_ZLIB
 
 const string test_output_time_compressed = R"YAML(
@@ -238,5 +296,42 @@ TEST(TestOutputVTK, write_data_compressed) {
     output_vtk->check_result_file("test1/test1-000000.vtu", "test_output_vtk_zlib_ref.vtu");
 }
 
+const string test_output_time_single_precision_compressed = R"YAML(
+file: ./test_single_zlib.pvd
+format: !vtk
+  variant: binary_zlib
+  single_precision: true
+)YAML";
+
+TEST(TestOutputVTK, write_read_single_precision_compressed) {
+	std::shared_ptr<TestOutputVTK> output_vtk = std::make_shared<TestOutputVTK>();
+
+	output_vtk->init_mesh(test_output_time_single_precision_compressed);
+    output_vtk->set_current_step(0);
+    output_vtk->set_field_data<3, FieldValue<3>::VectorFixed>("vector_field", "[0.5, 1.0, 1.5]", "0.5 1.0 1.5");
+    output_vtk->write_data();
+
+    output_vtk->check_vector_field_file("test_single_zlib/test_single_zlib-000000.vtu", DataType::float32);
+}
+
+const string test_output_time_compression_level = R"YAML(
+file: ./test_zlib_level.pvd
+format: !vtk
+  variant: binary_zlib
+  compression_level: 1
+)YAML";
+
+TEST(TestOutputVTK, write_read_compression_level) {
+	// data of larger mesh are compressed in several blocks in parallel
+	std::shared_ptr<TestOutputVTK> output_vtk = std::make_shared<TestOutputVTK>("/mesh/test_7590_elem.msh");
+
+	output_vtk->init_mesh(test_output_time_compression_level);
+    output_vtk->set_current_step(0);
+    output_vtk->set_field_data<3, FieldValue<3>::VectorFixed>("vector_field", "[0.5, 1.0, 1.5]", "0.5 1.0 1.5");
+    output_vtk->write_data();
+
+    output_vtk->check_vector_field_file("test_zlib_level/test_zlib_level-000000.vtu", DataType::float64);
+}
+
 #endif // FLOW123D_HAVE_ZLIB
 
@@ -0,0 +1,125 @@
+/*
+ * output_xdmf_test.cpp
+ *
+ * Test of output of time series to the single binary container described by XDMF file.
+ */
+
+#define TEST_USE_PETSC
+#define FEAL_OVERRIDE_ASSERTS
+#include <flow_gtest_mpi.hh>
+#include <mesh_constructor.hh>
+#include <fstream>
+
+#include "config.h"
+
+#include "io/output_time.hh"
+#include "io/output_xdmf.hh"
+#include "io/output_mesh.hh"
+#include "io/element_data_cache.hh"
+#include "mesh/mesh.h"
+#include "input/reader_to_storage.hh"
+#include "system/logger_options.hh"
+#include "system/sys_profiler.hh"
+#include "tools/time_governor.hh"
+
+
+const string test_output_time_xdmf = R"YAML(
+file: ./test_xdmf.xdmf
+format: !xdmf
+  variant: binary
+)YAML";
+
+
+class TestOutputXDMF : public OutputXDMF, public std::enable_shared_from_this<OutputXDMF> {
+public:
+    TestOutputXDMF()
+    : OutputXDMF()
+    {
+        Profiler::instance();
+        LoggerOptions::get_instance().set_log_file("");
+
+        FilePath mesh_file( string(UNIT_TESTS_SRC_DIR) + "/fields/simplest_cube_3d.msh", FilePath::input_file);
+        this->_mesh = mesh_full_constructor("{ mesh_file=\"" + (string)mesh_file + "\", optimize_mesh=false }");
+
+        this->write_time = 0.0; // hack: unset condition in OutputTime::write_time_frame and output is not performed
+    }
+
+    ~TestOutputXDMF()
+    {
+        delete this->_mesh;
+        LoggerOptions::get_instance().reset();
+    }
+
+    // initialize mesh with given yaml input
+    void init_mesh(string input_yaml)
+    {
+    	auto in_rec = Input::ReaderToStorage(input_yaml, const_cast<Input::Type::Record &>(OutputTime::get_input_type()), Input::FileFormat::format_YAML)
+        				.get_root_interface<Input::Record>();
+        this->init_from_input("dummy_equation", in_rec, std::make_shared<TimeUnitConversion>());
+
+        output_mesh_ = std::make_shared<OutputMesh>(*(this->_mesh));
+        output_mesh_->create_sub_mesh();
+        output_mesh_->make_serial_master_mesh();
+        this->set_output_data_caches(output_mesh_);
+    }
+
+    // set element data of scalar field to given value
+    void set_elem_data(string field_name, double value, double time)
+    {
+        auto output_cache_base = this->prepare_compute_data<double>(field_name, OutputTime::ELEM_DATA, 1, 1);
+        auto output_data_cache = std::dynamic_pointer_cast<ElementDataCache<double>>(output_cache_base);
+        for (uint i=0; i<output_data_cache->n_values(); ++i)
+            output_data_cache->store_value(i, &value);
+        this->update_time(time);
+    }
+
+    void write_frame(double value, double time)
+    {
+        this->set_elem_data("scalar_field", value, time);
+        this->write_data();
+        this->current_step++;
+        this->clear_data();
+    }
+
+    uint64_t container_size() {
+        return this->container_size_;
+    }
+
+    Mesh *_mesh;
+    std::shared_ptr<OutputMeshBase> output_mesh_;
+};
+
+
+TEST(TestOutputXDMF, write_time_series) {
+	std::shared_ptr<TestOutputXDMF> output = std::make_shared<TestOutputXDMF>();
+	output->init_mesh(test_output_time_xdmf);
+	unsigned int n_elements = output->output_mesh_->n_elements();
+
+	output->write_frame(0.5, 0.0);
+	uint64_t first_size = output->container_size();
+	output->write_frame(1.5, 1.0);
+
+	// second frame appends only field data
+	EXPECT_EQ(first_size + n_elements*sizeof(double), output->container_size());
+
+	// both frames refer to the same geometry, data of the second frame are stored at the end of the container
+	std::ifstream xdmf_file("test_xdmf.xdmf");
+	std::stringstream xdmf;
+	xdmf << xdmf_file.rdbuf();
+	std::string xdmf_str = xdmf.str();
+	EXPECT_NE(std::string::npos, xdmf_str.find("<Time Value=\"1\"/>"));
+	std::string geometry_item = "<Geometry GeometryType=\"XYZ\">";
+	std::size_t first_geometry = xdmf_str.find(geometry_item);
+	ASSERT_NE(std::string::npos, first_geometry);
+	std::size_t second_geometry = xdmf_str.find(geometry_item, first_geometry+1);
+	ASSERT_NE(std::string::npos, second_geometry);
+	EXPECT_EQ( xdmf_str.substr(first_geometry, xdmf_str.find("</Geometry>", first_geometry) - first_geometry),
+	           xdmf_str.substr(second_geometry, xdmf_str.find("</Geometry>", second_geometry) - second_geometry) );
+
+	// read data of the second frame
+	std::ifstream container("test_xdmf.bin", std::ios::binary);
+	container.seekg(first_size);
+	std::vector<double> values(n_elements);
+	container.read(reinterpret_cast<char *>(values.data()), n_elements*sizeof(double));
+	for (double val : values) EXPECT_DOUBLE_EQ(1.5, val);
+}
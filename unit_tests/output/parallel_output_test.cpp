@@ -251,3 +251,56 @@ TEST_F(TestParallelOutput, discontinuous_mesh)
         }
     }
 }
+
+
+const string refined_mesh_input = R"JSON(
+{
+    max_level = 1
+}
+)JSON";
+
+// collect coordinates of vertices of all elements of the output mesh
+std::vector<double> output_mesh_vertices(OutputMeshBase &output_mesh)
+{
+    std::vector<double> vertices;
+    for (const auto &ele : output_mesh)
+        for (auto &v : ele.vertex_list())
+            for (unsigned int i=0; i<3; ++i) vertices.push_back(v[i]);
+    return vertices;
+}
+
+TEST_F(TestParallelOutput, refined_discontinuous_mesh)
+{
+    check_distributions();
+    auto in_rec = Input::ReaderToStorage(refined_mesh_input, const_cast<Input::Type::Record &>(OutputMeshBase::get_input_type()),
+                                         Input::FileFormat::format_JSON).get_root_interface<Input::Record>();
+
+    // parallel master mesh contains refined local elements of each process
+    auto parallel_mesh = std::make_shared<OutputMeshDiscontinuous>(*my_mesh, in_rec);
+    parallel_mesh->create_refined_sub_mesh();
+    parallel_mesh->make_parallel_master_mesh();
+    auto parallel_master = parallel_mesh->get_master_mesh();
+    EXPECT_EQ(4, parallel_master->n_elements()); // one triangle of each process is split to 4 triangles
+    EXPECT_EQ(12, parallel_master->n_nodes());
+    std::vector<double> local_vertices = output_mesh_vertices(*parallel_master);
+    EXPECT_EQ(36, local_vertices.size());
+
+    // serial master mesh of the same refinement
+    auto serial_mesh = std::make_shared<OutputMeshDiscontinuous>(*my_mesh, in_rec);
+    serial_mesh->create_refined_sub_mesh();
+    serial_mesh->make_serial_master_mesh();
+
+    // parts of parallel master meshes must be the same as serial master mesh
+    int n_proc = my_mesh->get_el_ds()->np();
+    std::vector<double> all_vertices(n_proc * local_vertices.size());
+    MPI_Gather(local_vertices.data(), local_vertices.size(), MPI_DOUBLE,
+               all_vertices.data(), local_vertices.size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        auto serial_master = serial_mesh->get_master_mesh();
+        EXPECT_EQ(8, serial_master->n_elements());
+        std::vector<double> serial_vertices = output_mesh_vertices(*serial_master);
+        ASSERT_EQ(serial_vertices.size(), all_vertices.size());
+        for (unsigned int i=0; i<serial_vertices.size(); ++i)
+            EXPECT_DOUBLE_EQ(serial_vertices[i], all_vertices[i]);
+    }
+}
@@ -192,6 +192,54 @@ TEST(ReaderCache, find_header) {
 }
 
 
+TEST(ReaderCache, cached_data_frames) {
+	Profiler::instance();
+
+    // has to introduce some flag for passing absolute path to 'test_units' in source tree
+    FilePath::set_io_dirs(".",UNIT_TESTS_SRC_DIR,"",".");
+
+    Input::Record i_rec = get_input_record("{ mesh_file=\"fields/simplest_cube_base_data.msh\", optimize_mesh=false }");
+    FilePath file_name = i_rec.val<FilePath>("mesh_file");
+    Mesh * mesh = new Mesh(i_rec);
+    auto reader = ReaderCache::get_reader(file_name);
+    reader->read_physical_names(mesh);
+    reader->read_raw_mesh(mesh);
+    ReaderCache::get_element_ids(file_name, *mesh);
+
+    const unsigned int n_entities = 15;  // n bulk elements in mesh
+    const unsigned int bdr_shift = 9;    // n bulk elements in mesh
+    auto read_frame = [&](std::string field_name, double time, unsigned int n_comp) {
+        BaseMeshReader::HeaderQuery header_params(field_name, time, OutputTime::DiscreteSpace::ELEM_DATA);
+        auto header = ReaderCache::get_reader(file_name)->find_header(header_params);
+        return ReaderCache::get_element_data<double>(file_name, header, n_entities, n_comp, bdr_shift);
+    };
+
+    // same frames are shared
+    auto vector_0 = read_frame("vector_fixed", 0.0, 3);
+    EXPECT_EQ(vector_0, read_frame("vector_fixed", 0.0, 3));
+    EXPECT_EQ(1.0, (*vector_0)[0]);
+
+    // frame of new time replaces cached frame, replaced frame is still valid
+    auto vector_1 = read_frame("vector_fixed", 1.0, 3);
+    EXPECT_NE(vector_0, vector_1);
+    EXPECT_EQ(vector_1, read_frame("vector_fixed", 1.0, 3));
+    EXPECT_EQ(1.0, (*vector_0)[0]);
+    EXPECT_EQ(2.0, (*vector_1)[0]);
+
+    // memory limit allows only one frame, least recently used frame is released and read again
+    ReaderCache::set_memory_limit(n_entities * 3 * sizeof(double));
+    auto tensor_0 = read_frame("tensor_fixed", 0.0, 9);
+    EXPECT_EQ(tensor_0, read_frame("tensor_fixed", 0.0, 9));
+    auto vector_1_reread = read_frame("vector_fixed", 1.0, 3);
+    EXPECT_NE(vector_1, vector_1_reread);
+    EXPECT_EQ(2.0, (*vector_1_reread)[0]);
+    EXPECT_NE(tensor_0, read_frame("tensor_fixed", 0.0, 9));
+    ReaderCache::set_memory_limit(0);
+
+    delete mesh;
+}
+
+
 TEST(ReaderCache, get_reader) {
 	Profiler::instance();
 